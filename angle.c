@@ -14,13 +14,18 @@
  * limitations under the License.
  */
 
-#include "ballistics/ballistics.h"
+#include "ballistics_private.h"
 
 #include <math.h>
 
-// Used to determine bore angle
-double zero_angle(DragFunction drag_function, double drag_coefficient, double vi, double sight_height, double zero_range,
-                  double y_intercept) {
+#define ZERO_DEFAULT_TOLERANCE 0.01 // MOA
+#define ZERO_MAX_SECANT_ITERATIONS 12
+
+// Used to determine bore angle.  y_intercept is in feet, and each trajectory is integrated with a time step of
+// step feet over the velocity.
+static int zero_bisection(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                          double zero_range, double y_intercept, double step, const BallisticsOptions* options,
+                          ZeroResult* result, BallisticsStats* stats) {
 
   // Numerical Integration variables
   double t=0;
@@ -38,6 +43,9 @@ double zero_angle(DragFunction drag_function, double drag_coefficient, double vi
   double angle=0; // The actual angle of the bore.
 
   int quit=0; // We know it's time to quit our successive approximation loop when this is 1.
+  int iterations=0;
+  BALLISTICS_PROBE(long steps=0);
+  double tolerance = moa_to_rad(options->zero_tolerance > 0 ? options->zero_tolerance : ZERO_DEFAULT_TOLERANCE);
 
   // Start with a very coarse angular change, to quickly solve even large launch angle problems.
   da= deg_to_rad(14);
@@ -53,14 +61,16 @@ double zero_angle(DragFunction drag_function, double drag_coefficient, double vi
     vx=vi*cos(angle);
     Gx=GRAVITY*sin(angle);
     Gy=GRAVITY*cos(angle);
+    iterations++;
 
     for (t=0,x=0,y=-sight_height/12;x<=zero_range*3;t=t+dt) {
       vy1=vy;
       vx1=vx;
-      v=pow((pow(vx,2)+pow(vy,2)),0.5);
-      dt=1/v;
+      v = options->math == BALLISTICS_MATH_FAST ? sqrt(vx*vx + vy*vy) : pow((pow(vx,2)+pow(vy,2)),0.5);
+      dt=step/v;
 
-      dv = retard(drag_function, drag_coefficient, v);
+      dv = Ballistics_retard_at(options, drag_function, drag_coefficient, v, y);
+      BALLISTICS_PROBE(steps++);
       dvy = -dv*vy/v*dt;
       dvx = -dv*vx/v*dt;
 
@@ -88,9 +98,148 @@ double zero_angle(DragFunction drag_function, double drag_coefficient, double vi
       da=-da/2;
     }
 
-    if (fabs(da) < moa_to_rad(0.01)) quit=1; // If our accuracy is sufficient, we can stop approximating.
+    if (fabs(da) < tolerance) quit=1; // If our accuracy is sufficient, we can stop approximating.
     if (angle > deg_to_rad(45)) quit=1; // If we exceed the 45 degree launch angle, then the projectile just won't get there, so we stop trying.
   }
 
-  return rad_to_deg(angle); // Convert to degrees for return value.
-}
\ No newline at end of file
+  result->angle = rad_to_deg(angle); // Convert to degrees for return value.
+  result->tolerance = rad_to_moa(fabs(da));
+  result->iterations = iterations;
+  BALLISTICS_PROBE(if (stats) {
+    stats->steps += steps;
+    stats->retard_calls += steps;
+    stats->stop = angle > deg_to_rad(45) ? BALLISTICS_STOP_ANGLE_LIMIT : BALLISTICS_STOP_CONVERGED;
+  })
+  return angle > deg_to_rad(45) ? -1 : 0;
+}
+
+// The path, in feet, at exactly range feet for a bore angle in radians, on level ground.  Integrated the way
+// Ballistics_solve() integrates, and interpolated within the step that crosses range, so that it is a smooth
+// function of angle.  Returns NAN if the trajectory ends before range.
+static double zero_path_at(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                           double range, double angle, const BallisticsOptions* options,
+                           BallisticsStats* stats) {
+  double dt=0;
+  double v=0;
+  double vx=vi*cos(angle), vx1=0, vy=vi*sin(angle), vy1=0;
+  double dv=0;
+  double x=0, y=-sight_height/12;
+  double gx=GRAVITY*sin(angle), gy=GRAVITY*cos(angle);
+
+  while (x < range) {
+    vx1=vx;
+    vy1=vy;
+    v=sqrt(vx*vx + vy*vy);
+    dt=0.5/v;
+
+    dv = Ballistics_retard_at(options, drag_function, drag_coefficient, v, y);
+    BALLISTICS_PROBE(if (stats) { stats->steps++; stats->retard_calls++; });
+    vx = vx - dt*(vx/v)*dv + dt*gx;
+    vy = vy - dt*(vy/v)*dv + dt*gy;
+
+    double x0=x, y0=y;
+    x=x+dt*(vx+vx1)/2;
+    y=y+dt*(vy+vy1)/2;
+
+    if (x >= range) {
+      return y0 + (y - y0)*(range - x0)/(x - x0);
+    }
+    if (fabs(vy)>fabs(3*vx)) {
+      break;
+    }
+  }
+  return x >= range ? y : NAN;
+}
+
+// Secant iteration on path(angle) - y_intercept at the zero range, both in feet.
+static int zero_secant(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                       double zero_range, double y_intercept, const BallisticsOptions* options, ZeroResult* result,
+                       BallisticsStats* stats) {
+  double tolerance = moa_to_rad(options->zero_tolerance > 0 ? options->zero_tolerance : ZERO_DEFAULT_TOLERANCE);
+  double range = zero_range*3;
+  double target = y_intercept;
+
+  // The flat-fire estimate: fired level, the path misses by f0, and near level a bore angle a moves the path
+  // at the zero range by about range*tan(a).
+  double a0 = 0;
+  double f0 = zero_path_at(drag_function, drag_coefficient, vi, sight_height, range, a0, options, stats) - target;
+  double a1 = atan(-f0/range);
+  double f1 = zero_path_at(drag_function, drag_coefficient, vi, sight_height, range, a1, options, stats) - target;
+  int iterations = 2;
+  double da = a1 - a0;
+
+  int status = 0;
+  while (fabs(da) >= tolerance) {
+    if (isnan(f0) || isnan(f1) || f1 == f0 || iterations >= ZERO_MAX_SECANT_ITERATIONS) {
+      status = -1;
+      break;
+    }
+    da = -f1*(a1 - a0)/(f1 - f0);
+    a0 = a1;
+    f0 = f1;
+    a1 = a1 + da;
+    if (fabs(a1) > deg_to_rad(45)) {
+      status = -1;
+      break;
+    }
+    f1 = zero_path_at(drag_function, drag_coefficient, vi, sight_height, range, a1, options, stats) - target;
+    iterations++;
+  }
+  if (isnan(f1)) {
+    status = -1;
+  }
+
+  result->angle = rad_to_deg(a1);
+  result->tolerance = rad_to_moa(fabs(da));
+  result->iterations = iterations;
+  BALLISTICS_PROBE(if (stats && status == 0) stats->stop = BALLISTICS_STOP_CONVERGED);
+  return status;
+}
+
+// zero_angle_ex() with y_intercept in feet and the bisection's step, so that zero_angle() can keep its own.
+static int zero_search(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                       double zero_range, double y_intercept, double step, const BallisticsOptions* options,
+                       ZeroResult* result) {
+  static const BallisticsOptions defaults;
+  if (options == NULL) {
+    options = &defaults;
+  }
+
+  BallisticsProbe probe;
+  BallisticsStats* stats = BallisticsProbe_begin(&probe, BALLISTICS_CALL_ZERO_ANGLE, options);
+
+  int status;
+  if (options->zero_method == ZERO_METHOD_SECANT) {
+    status = zero_secant(drag_function, drag_coefficient, vi, sight_height, zero_range, y_intercept, options,
+                         result, stats);
+    if (status != 0) {
+      int secant_iterations = result->iterations;
+      status = zero_bisection(drag_function, drag_coefficient, vi, sight_height, zero_range, y_intercept, step,
+                              options, result, stats);
+      result->iterations += secant_iterations;
+    }
+  }
+  else {
+    status = zero_bisection(drag_function, drag_coefficient, vi, sight_height, zero_range, y_intercept, step,
+                            options, result, stats);
+  }
+
+  BALLISTICS_PROBE(if (stats) stats->iterations = result->iterations);
+  BallisticsProbe_end(&probe, stats, status);
+  return status;
+}
+
+int zero_angle_ex(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                  double zero_range, double y_intercept, const BallisticsOptions* options, ZeroResult* result) {
+  // Both searches integrate with Ballistics_solve()'s half-foot step.
+  return zero_search(drag_function, drag_coefficient, vi, sight_height, zero_range, y_intercept/12, 0.5, options,
+                     result);
+}
+
+double zero_angle(DragFunction drag_function, double drag_coefficient, double vi, double sight_height, double zero_range,
+                  double y_intercept) {
+  // As zero_angle() always has: y_intercept compared against the path in feet, and a one foot step.
+  ZeroResult result;
+  zero_search(drag_function, drag_coefficient, vi, sight_height, zero_range, y_intercept, 1, NULL, &result);
+  return result.angle;
+}
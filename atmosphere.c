@@ -14,9 +14,10 @@
  * limitations under the License.
  */
 
-#include "ballistics/ballistics.h"
+#include "ballistics_private.h"
 
 #include <math.h>
+#include <stdlib.h>
 
 // Drag coefficient atmospheric corrections
 static inline double calcFR(double temperature, double pressure, double relative_humidity) {
@@ -55,4 +56,94 @@ double atmosphere_correction(double drag_coefficient, double altitude, double ba
 	// Calculate the atmospheric correction factor
 	double cd = (fa*(1+ft-fp)*fr);
 	return drag_coefficient*cd;
-}
\ No newline at end of file
+}
+
+// The ICAO standard atmosphere, in feet, degrees Rankine and inches of mercury.
+#define ICAO_TEMPERATURE 518.67      // sea level
+#define ICAO_PRESSURE 29.92126       // sea level
+#define ICAO_LAPSE_RATE 0.00356616   // per foot, up to the tropopause
+#define ICAO_TROPOPAUSE 36089.24
+#define ICAO_G_OVER_R 0.01874393     // g0/R for dry air, degrees Rankine per foot
+#define RANKINE_OFFSET 459.67
+// Vapor pressure's share of the total that does not displace dry air's mass; see calcFR().
+#define VAPOR_DENSITY_DEFICIT 0.3783
+
+#define PROFILE_BELOW 5000.0  // feet below the firing point
+#define PROFILE_ABOVE 45000.0 // feet above the firing point
+#define PROFILE_STEP 20.0     // feet
+
+// The ICAO standard temperature at an altitude.
+static double icao_temperature(double altitude) {
+	return ICAO_TEMPERATURE - ICAO_LAPSE_RATE*fmin(altitude, ICAO_TROPOPAUSE);
+}
+
+// The pressure at altitude2, hydrostatically from pressure at altitude1, in air offset dt degrees from standard.
+static double hydrostatic(double pressure, double altitude1, double altitude2, double dt) {
+	double t1 = icao_temperature(altitude1) + dt;
+	double tp = icao_temperature(ICAO_TROPOPAUSE) + dt;
+	if (altitude1 < ICAO_TROPOPAUSE) {
+		double top = fmin(altitude2, ICAO_TROPOPAUSE);
+		pressure *= pow((icao_temperature(top) + dt)/t1, ICAO_G_OVER_R/ICAO_LAPSE_RATE);
+		altitude1 = top;
+	}
+	if (altitude2 > altitude1) {
+		pressure *= exp(-ICAO_G_OVER_R*(altitude2 - altitude1)/tp);
+	}
+	return pressure;
+}
+
+// Saturation vapor pressure over water, in inches of mercury (Magnus, with Alduchov & Eskridge's constants).
+static double saturation_pressure(double rankine) {
+	double celsius = (rankine - RANKINE_OFFSET - 32)/1.8;
+	return 6.1094*exp(17.625*celsius/(celsius + 243.04)) / 33.8639;
+}
+
+AtmosphereProfile* AtmosphereProfile_create(double altitude, double barometer, double temperature,
+                                            double relative_humidity) {
+	int points = (int)((PROFILE_BELOW + PROFILE_ABOVE)/PROFILE_STEP) + 1;
+	AtmosphereProfile* profile = malloc(sizeof(AtmosphereProfile) + 2*points*sizeof(double));
+	if (profile == NULL) {
+		return NULL;
+	}
+	profile->height0 = -PROFILE_BELOW;
+	profile->inv_step = 1/PROFILE_STEP;
+	profile->points = points;
+
+	// The standard atmosphere, shifted to the measured temperature, with the reported barometer scaling the
+	// standard pressure at the firing point.
+	double dt = temperature + RANKINE_OFFSET - icao_temperature(altitude);
+	double station_pressure = hydrostatic(ICAO_PRESSURE, 0, altitude, 0) * barometer/ICAO_PRESSURE;
+
+	// Below the firing point, step down from it; the troposphere's formula holds in either direction.
+	for (int i = 0; i < points; i++) {
+		double z = altitude + profile->height0 + i*PROFILE_STEP;
+		double t = icao_temperature(z) + dt;
+		double p = z >= altitude
+		    ? hydrostatic(station_pressure, altitude, z, dt)
+		    : station_pressure * pow(t/(icao_temperature(altitude) + dt), ICAO_G_OVER_R/ICAO_LAPSE_RATE);
+		double vapor = relative_humidity * saturation_pressure(t);
+		profile->air[2*i] = (p - VAPOR_DENSITY_DEFICIT*vapor)/ICAO_PRESSURE * ICAO_TEMPERATURE/t;
+		profile->air[2*i + 1] = sqrt(t/ICAO_TEMPERATURE);
+	}
+	return profile;
+}
+
+AtmosphereProfile* AtmosphereProfile_create_standard(double altitude) {
+	return AtmosphereProfile_create(altitude, ICAO_PRESSURE, icao_temperature(altitude) - RANKINE_OFFSET, 0);
+}
+
+void AtmosphereProfile_free(AtmosphereProfile* profile) {
+	free(profile);
+}
+
+double AtmosphereProfile_density_ratio(const AtmosphereProfile* profile, double height) {
+	double density, sound;
+	AtmosphereProfile_lookup(profile, height, &density, &sound);
+	return density;
+}
+
+double AtmosphereProfile_speed_of_sound(const AtmosphereProfile* profile, double height) {
+	double density, sound;
+	AtmosphereProfile_lookup(profile, height, &density, &sound);
+	return sound*DRAG_TABLE_SPEED_OF_SOUND;
+}
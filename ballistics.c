@@ -14,165 +14,414 @@
  * limitations under the License.
  */
 
-#include "ballistics/ballistics.h"
+#include "ballistics_private.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
-/**
- * A ballistics solution for a projectile at a certain yardage.
- */
-typedef struct {
-  double range_yards;
-  double path_inches;
-  double moa_correction;
-  double seconds;
-  double windage_inches;
-  double windage_moa;
-  double v_fps; // total velocity -> vector product of vx and vy
-  double vx_fps; // velocity of projectile in the bore direction
-  double vy_fps; // velocity of projectile perpendicular to the bore direction
-} Point;
-
-struct Ballistics {
-  Point *yardages;
-  int max_yardage;
-};
-
-Ballistics* Ballistics_alloc() {
+// Allocates columns for capacity rows, rounded up so that every column starts on a cache line.
+static double* Ballistics_alloc_columns(int* capacity) {
+  *capacity = (*capacity + 7) & ~7;
+  return aligned_alloc(64, sizeof(double) * BALLISTICS_COLUMNS * *capacity);
+}
+
+Ballistics* Ballistics_alloc(int capacity) {
   Ballistics* sln = malloc(sizeof(Ballistics));
-  sln->yardages = malloc(sizeof(Point) * BALLISTICS_COMPUTATION_MAX_YARDS);
+  if (sln == NULL) {
+    return NULL;
+  }
+  sln->columns = Ballistics_alloc_columns(&capacity);
+  if (sln->columns == NULL) {
+    free(sln);
+    return NULL;
+  }
+  sln->capacity = capacity;
+  sln->max_yardage = 0;
+  sln->drag_evaluations = 0;
+  sln->refs = 1;
+  sln->vi = 0;
+  sln->windage_stale = 0;
+  sln->sink = NULL;
   return sln;
 }
 
+// Makes room for at least rows rows, discarding the current solution.  Returns -1 if the memory is not available.
+static int Ballistics_reserve(Ballistics* ballistics, int rows) {
+  if (rows <= ballistics->capacity) {
+    return 0;
+  }
+  double* columns = Ballistics_alloc_columns(&rows);
+  if (columns == NULL) {
+    return -1;
+  }
+  free(ballistics->columns);
+  ballistics->columns = columns;
+  ballistics->capacity = rows;
+  return 0;
+}
+
+int Ballistics_grow(Ballistics* ballistics, int rows) {
+  if (rows <= ballistics->capacity) {
+    return 0;
+  }
+  double* columns = Ballistics_alloc_columns(&rows);
+  if (columns == NULL) {
+    return -1;
+  }
+  for (int c = 0; c < BALLISTICS_COLUMNS; c++) {
+    memcpy(columns + (size_t)c*rows, ballistics->columns + (size_t)c*ballistics->capacity,
+           sizeof(double) * ballistics->capacity);
+  }
+  free(ballistics->columns);
+  ballistics->columns = columns;
+  ballistics->capacity = rows;
+  return 0;
+}
+
+// Rows needed to hold yards 0 through max_yards.
+static int Ballistics_rows(size_t max_yards) {
+  return max_yards < BALLISTICS_COMPUTATION_MAX_YARDS ? (int)max_yards + 1 : BALLISTICS_COMPUTATION_MAX_YARDS;
+}
+
+Ballistics* Ballistics_create(size_t max_yards) {
+  return Ballistics_alloc(Ballistics_rows(max_yards));
+}
+
+void Ballistics_reset(Ballistics* ballistics) {
+  ballistics->max_yardage = 0;
+  ballistics->drag_evaluations = 0;
+  ballistics->windage_stale = 0;
+}
+
+Ballistics* Ballistics_retain(Ballistics* ballistics) {
+  __atomic_add_fetch(&ballistics->refs, 1, __ATOMIC_RELAXED);
+  return ballistics;
+}
+
 void Ballistics_free(Ballistics* ballistics) {
-  free(ballistics->yardages);
+  if (__atomic_sub_fetch(&ballistics->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+    return;
+  }
+  free(ballistics->columns);
   free(ballistics);
 }
 
-double Ballistics_get_range(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].range_yards;
+long Ballistics_get_drag_evaluations(Ballistics* ballistics) {
+  return ballistics->drag_evaluations;
+}
+
+static inline double Ballistics_get(Ballistics* ballistics, BallisticsColumn column, int yardage) {
+  if (yardage >= 0 && yardage < ballistics->max_yardage) {
+    return Ballistics_column(ballistics, column)[yardage];
   }
   else return 0;
 }
 
+double Ballistics_get_range(Ballistics* ballistics, int yardage) {
+  return Ballistics_get(ballistics, BALLISTICS_COL_RANGE, yardage);
+}
+
 double Ballistics_get_path(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].path_inches;
-  }
-  else return 0;
+  return Ballistics_get(ballistics, BALLISTICS_COL_PATH, yardage);
 }
 
 double Ballistics_get_moa(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].moa_correction;
-  }
-  else return 0;
+  return Ballistics_get(ballistics, BALLISTICS_COL_MOA, yardage);
 }
 
-
 double Ballistics_get_time(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].seconds;
-  }
-  else return 0;
+  return Ballistics_get(ballistics, BALLISTICS_COL_TIME, yardage);
+}
+
+// Windage, in inches, at a row for the pending crosswind.  Range is stored in yards, so x comes back to
+// within rounding of the feet the row was recorded at.
+static inline double Ballistics_stale_windage(Ballistics* ballistics, int row) {
+  return windage(ballistics->crosswind, ballistics->vi, Ballistics_column(ballistics, BALLISTICS_COL_RANGE)[row]*3,
+                 Ballistics_column(ballistics, BALLISTICS_COL_TIME)[row]);
 }
 
 double Ballistics_get_windage(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].windage_inches;
+  if (ballistics->windage_stale && yardage >= 0 && yardage < ballistics->max_yardage) {
+    return Ballistics_stale_windage(ballistics, yardage);
   }
-  else return 0;
+  return Ballistics_get(ballistics, BALLISTICS_COL_WINDAGE, yardage);
 }
 
 double Ballistics_get_windage_moa(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].windage_moa;
+  if (ballistics->windage_stale && yardage >= 0 && yardage < ballistics->max_yardage) {
+    double x = Ballistics_column(ballistics, BALLISTICS_COL_RANGE)[yardage]*3;
+    return rad_to_moa(atan((Ballistics_stale_windage(ballistics, yardage)/12) / x));
   }
-  else return 0;
+  return Ballistics_get(ballistics, BALLISTICS_COL_WINDAGE_MOA, yardage);
 }
 
-double Ballistics_get_v_fps(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].v_fps;
+// Recomputes both windage columns for the pending crosswind.  The windage loop is a multiply and a divide
+// per row, which the compiler vectorizes; only the angles need atan() row by row.
+static void Ballistics_refresh_windage(Ballistics* ballistics) {
+  int n = ballistics->max_yardage;
+  double cwind = ballistics->crosswind;
+  double vi = ballistics->vi;
+  const double* restrict range = Ballistics_column(ballistics, BALLISTICS_COL_RANGE);
+  const double* restrict time = Ballistics_column(ballistics, BALLISTICS_COL_TIME);
+  double* restrict windage_inches = Ballistics_column(ballistics, BALLISTICS_COL_WINDAGE);
+  double* restrict windage_moa = Ballistics_column(ballistics, BALLISTICS_COL_WINDAGE_MOA);
+
+  for (int i = 0; i < n; i++) {
+    windage_inches[i] = windage(cwind, vi, range[i]*3, time[i]);
   }
-  else return 0;
+  for (int i = 0; i < n; i++) {
+    windage_moa[i] = rad_to_moa(atan((windage_inches[i]/12) / (range[i]*3)));
+  }
+  ballistics->windage_stale = 0;
 }
 
-double Ballistics_get_vx_fps(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].vx_fps;
+void Ballistics_update_crosswind(Ballistics* ballistics, double wind_speed, double wind_angle) {
+  ballistics->crosswind = crosswind(wind_speed, wind_angle);
+  Ballistics_refresh_windage(ballistics);
+}
+
+void Ballistics_update_crosswind_lazy(Ballistics* ballistics, double wind_speed, double wind_angle) {
+  ballistics->crosswind = crosswind(wind_speed, wind_angle);
+  ballistics->windage_stale = 1;
+}
+
+// Brings a column up to date before it is handed out.
+static void Ballistics_column_ready(Ballistics* ballistics, BallisticsColumn column) {
+  if (ballistics->windage_stale && (column == BALLISTICS_COL_WINDAGE || column == BALLISTICS_COL_WINDAGE_MOA)) {
+    Ballistics_refresh_windage(ballistics);
   }
-  else return 0;
+}
+
+double Ballistics_get_v_fps(Ballistics* ballistics, int yardage) {
+  return Ballistics_get(ballistics, BALLISTICS_COL_V, yardage);
+}
+
+double Ballistics_get_vx_fps(Ballistics* ballistics, int yardage) {
+  return Ballistics_get(ballistics, BALLISTICS_COL_VX, yardage);
 }
 
 double Ballistics_get_vy_fps(Ballistics* ballistics, int yardage) {
-  if (yardage < ballistics->max_yardage) {
-    return ballistics->yardages[yardage].vy_fps;
+  return Ballistics_get(ballistics, BALLISTICS_COL_VY, yardage);
+}
+
+int Ballistics_get_max_yardage(Ballistics* ballistics) {
+  return ballistics->max_yardage;
+}
+
+const double* Ballistics_column_ptr(Ballistics* ballistics, BallisticsColumn column) {
+  if (column < 0 || column >= BALLISTICS_COLUMNS) {
+    return NULL;
   }
-  else return 0;
+  Ballistics_column_ready(ballistics, column);
+  return Ballistics_column(ballistics, column);
+}
+
+int Ballistics_copy_column(Ballistics* ballistics, BallisticsColumn column, int start, int count, int stride,
+                           double* out) {
+  if (column < 0 || column >= BALLISTICS_COLUMNS || start < 0 || count < 0 || stride < 1) {
+    return 0;
+  }
+  if (start >= ballistics->max_yardage) {
+    return 0;
+  }
+  if (count > ballistics->max_yardage - start) {
+    count = ballistics->max_yardage - start;
+  }
+
+  Ballistics_column_ready(ballistics, column);
+  const double* src = Ballistics_column(ballistics, column) + start;
+  if (stride == 1) {
+    memcpy(out, src, sizeof(double) * count);
+  }
+  else {
+    for (int i = 0; i < count; i++) {
+      out[(size_t)i * stride] = src[i];
+    }
+  }
+  return count;
+}
+
+// The row i, below the last, with time[i] <= t <= time[i+1], for t within the solution.  Searches forward from
+// hint by doubling steps, so that a cursor moving forward a row or two per frame costs a comparison or two.
+static int Ballistics_time_row(const double* time, int n, double t, int hint) {
+  int lo, hi;
+  if (hint < 0 || hint > n - 2) {
+    hint = 0;
+  }
+  if (t >= time[hint]) {
+    int step = 1;
+    lo = hint;
+    hi = lo + 1;
+    while (hi < n - 1 && time[hi] <= t) {
+      lo = hi;
+      step *= 2;
+      hi = lo + step < n - 1 ? lo + step : n - 1;
+    }
+  }
+  else {
+    lo = 0;
+    hi = hint;
+  }
+  while (hi - lo > 1) {
+    int mid = lo + (hi - lo)/2;
+    if (time[mid] <= t) lo = mid; else hi = mid;
+  }
+  return lo;
+}
+
+// Fills row with the solution at time t, between rows i and i + 1.
+static void Ballistics_time_interpolate(Ballistics* ballistics, int i, double t, double* row) {
+  const double* time = Ballistics_column(ballistics, BALLISTICS_COL_TIME);
+  double dt = i + 1 < ballistics->max_yardage ? time[i+1] - time[i] : 0;
+  double f = dt > 0 ? (t - time[i])/dt : 0;
+  for (int column = 0; column < BALLISTICS_COLUMNS; column++) {
+    const double* c = Ballistics_column(ballistics, column);
+    row[column] = f > 0 ? c[i] + f*(c[i+1] - c[i]) : c[i];
+  }
+  row[BALLISTICS_COL_TIME] = t;
+  // Angles are not linear in range; take them from the interpolated position, as Ballistics_record() does.
+  double x = row[BALLISTICS_COL_RANGE]*3;
+  row[BALLISTICS_COL_MOA] = -rad_to_moa(atan((row[BALLISTICS_COL_PATH]/12) / x));
+  row[BALLISTICS_COL_WINDAGE_MOA] = rad_to_moa(atan((row[BALLISTICS_COL_WINDAGE]/12) / x));
+}
+
+int Ballistics_state_at_time(Ballistics* ballistics, double seconds, BallisticsTimeCursor* cursor, double* row) {
+  int n = ballistics->max_yardage;
+  const double* time = Ballistics_column(ballistics, BALLISTICS_COL_TIME);
+  if (n == 0 || !(seconds >= time[0] && seconds <= time[n-1])) {
+    return -1;
+  }
+  Ballistics_column_ready(ballistics, BALLISTICS_COL_WINDAGE);
+  int i = n > 1 ? Ballistics_time_row(time, n, seconds, cursor ? cursor->row : 0) : 0;
+  if (cursor) {
+    cursor->row = i;
+  }
+  Ballistics_time_interpolate(ballistics, i, seconds, row);
+  return 0;
+}
+
+size_t Ballistics_states_at_times(Ballistics* ballistics, const double* seconds, size_t n, double* rows) {
+  BallisticsTimeCursor cursor = {0};
+  size_t found = 0;
+  for (size_t k = 0; k < n; k++) {
+    double* row = rows + k*BALLISTICS_COLUMNS;
+    if (Ballistics_state_at_time(ballistics, seconds[k], &cursor, row) == 0) {
+      found++;
+    }
+    else {
+      for (int column = 0; column < BALLISTICS_COLUMNS; column++) {
+        row[column] = NAN;
+      }
+    }
+  }
+  return found;
 }
 
 int Ballistics_solve(Ballistics** ballistics, DragFunction drag_function, double drag_coefficient, double vi,
                      double sight_height, double shooting_angle, double zero_angle, double wind_speed, double wind_angle) {
-  double t=0;
-  double dt=0;
-  double v=0;
-  double vx=0, vx1=0, vy=0, vy1=0;
-  double dv=0, dvx=0, dvy=0;
-  double x=0, y=0;
-
-  double hwind = headwind(wind_speed, wind_angle);
-  double cwind = crosswind(wind_speed, wind_angle);
-
-  double gy = GRAVITY*cos(deg_to_rad((shooting_angle + zero_angle)));
-  double gx = GRAVITY*sin(deg_to_rad((shooting_angle + zero_angle)));
-
-  *ballistics = Ballistics_alloc();
-
-  vx = vi * cos(deg_to_rad(zero_angle));
-  vy = vi * sin(deg_to_rad(zero_angle));
-
-  y = -sight_height/12; // y is in feet
-
-  int n = 0;
-  for (t = 0;; t = t + dt) {
-    vx1 = vx;
-    vy1 = vy;
-    v = pow(pow(vx,2)+pow(vy,2),0.5);
-    dt = 0.5/v;
-
-    // Compute acceleration using the drag function retardation  
-    dv = retard(drag_function, drag_coefficient, v+hwind);
-    dvx = -(vx/v)*dv;
-    dvy = -(vy/v)*dv;
-
-    // Compute velocity, including the resolved gravity vectors.  
-    vx = vx + dt*dvx + dt*gx;
-    vy = vy + dt*dvy + dt*gy;
-
-    if (x/3 >= n) {
-      Point* s = &(*ballistics)->yardages[n];
-      s->range_yards = x/3;
-      s->path_inches = y*12;
-      s->moa_correction = -rad_to_moa(atan(y / x));
-      s->seconds = t+dt;
-      s->windage_inches = windage(cwind, vi, x, t + dt);
-      s->windage_moa = rad_to_moa(atan((s->windage_inches/12) / x));
-      s->v_fps = v;
-      s->vx_fps = vx;
-      s->vy_fps = vy;
-      n++;
-    }
+  BallisticsInput in;
+  in.drag_function = drag_function;
+  in.drag_coefficient = drag_coefficient;
+  in.vi = vi;
+  in.sight_height = sight_height;
+  in.shooting_angle = shooting_angle;
+  in.zero_angle = zero_angle;
+  in.wind_speed = wind_speed;
+  in.wind_angle = wind_angle;
+  return Ballistics_solve_ex(ballistics, &in, NULL);
+}
 
-    // Compute position based on average velocity.
-    x = x + dt * (vx+vx1)/2;
-    y = y + dt * (vy+vy1)/2;
+// Integrates into ballistics, stopping after the last sample.
+int Ballistics_integrate(Ballistics* ballistics, const BallisticsSamples* samples, const BallisticsInput* in,
+                         const BallisticsOptions* options) {
+  static const BallisticsOptions defaults;
+  if (options == NULL) {
+    options = &defaults;
+  }
+
+  BallisticsProbe probe;
+  BallisticsStats* stats = BallisticsProbe_begin(&probe, BALLISTICS_CALL_SOLVE, options);
+  BALLISTICS_PROBE(if (stats) stats->iterations = 1);
 
-    if (fabs(vy)>fabs(3*vx) || n>=BALLISTICS_COMPUTATION_MAX_YARDS) break;
+  int n;
+  switch (options->engine) {
+    case BALLISTICS_ENGINE_RK45:
+      n = Ballistics_integrate_rk45(ballistics, in, options, samples, stats);
+      break;
+    default:
+      n = Ballistics_integrate_euler(ballistics, in, options, samples, stats);
+      break;
   }
 
-  (*ballistics)->max_yardage = n;
+  ballistics->max_yardage = n;
+  ballistics->vi = in->vi;
+  ballistics->windage_stale = 0;
+  BallisticsProbe_end(&probe, stats, n);
   return n;
-}
\ No newline at end of file
+}
+
+// Every yard from the muzzle, in rows.
+static BallisticsSamples Ballistics_yards(int rows) {
+  BallisticsSamples samples = {NULL, 0, 1, rows, 0};
+  return samples;
+}
+
+int Ballistics_solve_ex(Ballistics** ballistics, const BallisticsInput* in, const BallisticsOptions* options) {
+  BallisticsSamples samples = Ballistics_yards(BALLISTICS_COMPUTATION_MAX_YARDS);
+  *ballistics = Ballistics_alloc(samples.count);
+  return Ballistics_integrate(*ballistics, &samples, in, options);
+}
+
+int Ballistics_solve_into(Ballistics* ballistics, size_t max_yards, const BallisticsInput* in,
+                          const BallisticsOptions* options) {
+  BallisticsSamples samples = Ballistics_yards(Ballistics_rows(max_yards));
+  Ballistics_reset(ballistics);
+  if (Ballistics_reserve(ballistics, samples.count) != 0) {
+    return -1;
+  }
+  return Ballistics_integrate(ballistics, &samples, in, options);
+}
+
+// Solves into ballistics at the requested samples only.
+static int Ballistics_solve_samples(Ballistics* ballistics, const BallisticsSamples* samples,
+                                    const BallisticsInput* in, const BallisticsOptions* options) {
+  Ballistics_reset(ballistics);
+  if (samples->count <= 0) {
+    return 0;
+  }
+  if (Ballistics_reserve(ballistics, samples->count) != 0) {
+    return -1;
+  }
+  return Ballistics_integrate(ballistics, samples, in, options);
+}
+
+int Ballistics_solve_ranges(Ballistics* ballistics, const double* ranges, size_t n, const BallisticsInput* in,
+                            const BallisticsOptions* options) {
+  if (n > BALLISTICS_COMPUTATION_MAX_YARDS) {
+    return -1;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (!(ranges[i] >= 0) || (i > 0 && ranges[i] < ranges[i-1])) {
+      return -1;
+    }
+  }
+
+  BallisticsSamples samples = {ranges, 0, 0, (int)n, 1};
+  return Ballistics_solve_samples(ballistics, &samples, in, options);
+}
+
+int Ballistics_solve_steps(Ballistics* ballistics, double start_yards, double step_yards, double end_yards,
+                           const BallisticsInput* in, const BallisticsOptions* options) {
+  if (!(start_yards >= 0 && step_yards > 0 && end_yards >= start_yards)) {
+    return -1;
+  }
+  // Tolerate end_yards landing a rounding error short of the last step.
+  double count = floor((end_yards - start_yards)/step_yards + 1e-9) + 1;
+  if (count > BALLISTICS_COMPUTATION_MAX_YARDS) {
+    return -1;
+  }
+
+  BallisticsSamples samples = {NULL, start_yards, step_yards, (int)count, 1};
+  return Ballistics_solve_samples(ballistics, &samples, in, options);
+}
@@ -0,0 +1,364 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Library-internal view of a solution.  Not installed; shared by the solver translation units.
+
+#include "ballistics/ballistics.h"
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Takes the rows of a solve in place of the columns, as the integrator records them; e.g. to fit or search them
+ * without storing a table.  row() receives the arguments of Ballistics_record_drift().
+ */
+typedef struct BallisticsRowSink BallisticsRowSink;
+struct BallisticsRowSink {
+  void (*row)(BallisticsRowSink* sink, double x, double y, double t, double v, double vx, double vy,
+              double windage_inches);
+};
+
+/**
+ * A ballistics solution, stored by column: BALLISTICS_COLUMNS arrays of capacity doubles each, back to back in
+ * one cache-line aligned block, so that each quantity is contiguous over range.
+ */
+struct Ballistics {
+  double* columns;
+  int capacity;    // rows allocated per column
+  int max_yardage; // rows solved
+  long drag_evaluations;
+  int refs;        // references held; see Ballistics_retain()
+  double vi;       // muzzle velocity of the solve, for recomputing windage
+  int windage_stale; // the windage columns are yet to be recomputed for crosswind
+  double crosswind;
+  BallisticsRowSink* sink; // when not NULL, receives the rows instead of the columns
+};
+
+static inline double* Ballistics_column(Ballistics* ballistics, BallisticsColumn column) {
+  return ballistics->columns + (size_t)column * ballistics->capacity;
+}
+
+Ballistics* Ballistics_alloc(int capacity);
+
+// Makes room for at least rows rows, keeping the rows already stored.  Returns -1 if the memory is not available.
+int Ballistics_grow(Ballistics* ballistics, int rows);
+
+// Instrumentation.  Solvers open a probe per call; it hands back the stats to count into, or NULL when nobody
+// asked for them.  Counting code goes inside BALLISTICS_PROBE() so that it compiles out with the probes.
+#ifdef BALLISTICS_INSTRUMENTATION
+#define BALLISTICS_PROBE(statement) statement
+#else
+#define BALLISTICS_PROBE(statement)
+#endif
+
+typedef struct {
+  BallisticsStats stats;
+  BallisticsStats* out;
+  double start;
+} BallisticsProbe;
+
+#ifdef BALLISTICS_INSTRUMENTATION
+BallisticsStats* BallisticsProbe_begin(BallisticsProbe* probe, BallisticsCall call, const BallisticsOptions* options);
+/**
+ * Finishes the call with its return value, delivering the stats if the probe was opened.
+ */
+void BallisticsProbe_end(BallisticsProbe* probe, BallisticsStats* stats, int status);
+#else
+static inline BallisticsStats* BallisticsProbe_begin(BallisticsProbe* probe, BallisticsCall call,
+                                                     const BallisticsOptions* options) {
+  (void)probe; (void)call; (void)options;
+  return NULL;
+}
+static inline void BallisticsProbe_end(BallisticsProbe* probe, BallisticsStats* stats, int status) {
+  (void)probe; (void)stats; (void)status;
+}
+#endif
+
+/**
+ * Where an integrator records rows: row i is the sample at range start + i*step yards, or at ranges[i] when
+ * ranges is given, for i < count.  Unless interpolate is set, the Euler engine keeps its historical behavior of
+ * recording each row at the first step that reaches it; otherwise every engine records the state interpolated
+ * to exactly the sample's range.  Integrators read count again after every row, so a BallisticsRowSink can stop
+ * them early by lowering it to the rows it has seen.
+ */
+typedef struct {
+  const double* ranges;
+  double start;
+  double step;
+  int count;
+  int interpolate;
+} BallisticsSamples;
+
+static inline double BallisticsSamples_range(const BallisticsSamples* samples, int i) {
+  return samples->ranges ? samples->ranges[i] : samples->start + i*samples->step;
+}
+
+/**
+ * Integrates with the engine options select, recording the requested samples into ballistics.
+ * @return the number of rows recorded.
+ */
+int Ballistics_integrate(Ballistics* ballistics, const BallisticsSamples* samples, const BallisticsInput* in,
+                         const BallisticsOptions* options);
+
+/**
+ * Integrates with the standard Euler engine, Solver<double> (solver.cpp), recording the requested samples into
+ * ballistics.
+ * @param stats counted into when not NULL
+ * @return the number of rows recorded.
+ */
+int Ballistics_integrate_euler(Ballistics* ballistics, const BallisticsInput* in, const BallisticsOptions* options,
+                               const BallisticsSamples* samples, BallisticsStats* stats);
+
+/**
+ * Integrates with the adaptive Dormand-Prince engine (rk45.c), recording the requested samples into ballistics.
+ * @param stats counted into when not NULL
+ * @return the number of rows recorded.
+ */
+int Ballistics_integrate_rk45(Ballistics* ballistics, const BallisticsInput* in, const BallisticsOptions* options,
+                              const BallisticsSamples* samples, BallisticsStats* stats);
+
+/**
+ * A drag curve resampled to cd[i] at Mach mach0 + i/inv_step, for i < points.
+ */
+struct DragTable {
+  double mach0;
+  double inv_step;
+  int points;
+  double cd[];
+};
+
+static inline double DragTable_lookup(const DragTable* table, double mach) {
+  double u = (mach - table->mach0) * table->inv_step;
+  if (!(u > 0)) {
+    return table->cd[0];
+  }
+  if (u >= table->points - 1) {
+    return table->cd[table->points - 1];
+  }
+  int i = (int)u;
+  double f = u - i;
+  return table->cd[i] + f*(table->cd[i+1] - table->cd[i]);
+}
+
+static inline double DragTable_retard_inline(const DragTable* table, double drag_coefficient, double vp) {
+  double cd = DragTable_lookup(table, vp * (1/DRAG_TABLE_SPEED_OF_SOUND));
+  return cd * vp*vp * DRAG_TABLE_RETARDATION / drag_coefficient;
+}
+
+/**
+ * Retardation evaluated the way options select: options->drag_table if one is given, otherwise drag_function
+ * evaluated as options->drag_mode says.
+ */
+static inline double Ballistics_retard(const BallisticsOptions* options, DragFunction drag_function,
+                                       double drag_coefficient, double vp) {
+  if (options->drag_table) {
+    return DragTable_retard_inline(options->drag_table, drag_coefficient, vp);
+  }
+  if (options->drag_mode == DRAG_MODE_TABLE) {
+    return retard_table(drag_function, drag_coefficient, vp);
+  }
+  if (options->math == BALLISTICS_MATH_FAST) {
+    return retard_fast(drag_function, drag_coefficient, vp);
+  }
+  return retard(drag_function, drag_coefficient, vp);
+}
+
+/**
+ * Density and speed of sound, as ratios to the ICAO sea level standard, every 1/inv_step feet above the firing
+ * point from height0, for points entries.
+ */
+struct AtmosphereProfile {
+  double height0;
+  double inv_step;
+  int points;
+  double air[]; // density ratio and speed of sound ratio, interleaved
+};
+
+static inline void AtmosphereProfile_lookup(const AtmosphereProfile* profile, double height, double* density,
+                                            double* sound) {
+  double u = (height - profile->height0) * profile->inv_step;
+  if (!(u > 0)) u = 0;
+  if (u > profile->points - 1) u = profile->points - 1;
+  int i = (int)u;
+  if (i == profile->points - 1) i--;
+  double f = u - i;
+  const double* a = profile->air + 2*i;
+  *density = a[0] + f*(a[2] - a[0]);
+  *sound = a[1] + f*(a[3] - a[1]);
+}
+
+/**
+ * Ballistics_retard() at height feet above the firing point.  Drag is Cd(v/c)*rho*v^2, and drag functions are
+ * standardized at sea level density rho0 and speed of sound c0, so in other air the retardation is the standard
+ * one at v*c0/c, scaled by (c/c0)^2 * rho/rho0.
+ */
+static inline double Ballistics_retard_at(const BallisticsOptions* options, DragFunction drag_function,
+                                          double drag_coefficient, double vp, double height) {
+  if (options->atmosphere == NULL) {
+    return Ballistics_retard(options, drag_function, drag_coefficient, vp);
+  }
+  double density, sound;
+  AtmosphereProfile_lookup(options->atmosphere, height, &density, &sound);
+  return Ballistics_retard(options, drag_function, drag_coefficient, vp/sound) * sound*sound*density;
+}
+
+/**
+ * Wind zones in feet of range, followed by a sentinel zone that starts at infinity.
+ */
+typedef struct {
+  double start;
+  double headwind;
+  double crosswind;
+} WindZone;
+
+struct WindProfile {
+  int zones;
+  WindZone zone[];
+};
+
+/**
+ * An integrator's place in the wind.  Zones are entered in order as the trajectory advances, so finding the
+ * wind at each step is a comparison against the next zone's start.
+ *
+ * Within a zone of crosswind w, drag pulls the bullet's sideways velocity vz toward w at the same relative rate
+ * as it slows the downrange velocity vx, so (vz - w)/vx keeps its value from the zone's entry a.  Integrating,
+ * the drift is z = z_a + w*(t - t_a) + (vz_a - w)*(x - x_a)/vx_a.  From the muzzle, where vz is 0 and vx is vi,
+ * this is the lag rule windage() applies.
+ */
+typedef struct {
+  const WindZone* zone; // the current zone; NULL for the input's constant wind
+  double next;          // where the next zone starts, in feet
+  double hwind;
+  double cwind;
+  double x0, t0;        // where and when the current zone was entered
+  double vx0;           // the downrange velocity there, in ft/s; vi at the muzzle
+  double vz0;           // the sideways velocity there, in in/s
+  double drift0;        // windage accumulated before it, in inches
+} WindCursor;
+
+static inline void WindCursor_start(WindCursor* cursor, const BallisticsOptions* options, const BallisticsInput* in) {
+  cursor->x0 = cursor->t0 = cursor->vz0 = cursor->drift0 = 0;
+  cursor->vx0 = in->vi;
+  if (options->wind == NULL) {
+    cursor->zone = NULL;
+    cursor->next = INFINITY;
+    cursor->hwind = headwind(in->wind_speed, in->wind_angle);
+    cursor->cwind = crosswind(in->wind_speed, in->wind_angle);
+  }
+  else {
+    cursor->zone = options->wind->zone;
+    cursor->next = cursor->zone[1].start;
+    cursor->hwind = cursor->zone[0].headwind;
+    cursor->cwind = cursor->zone[0].crosswind;
+  }
+}
+
+/**
+ * Windage, in inches, at range x feet and time t, in the current zone.  In the first zone this is windage()
+ * itself.
+ */
+static inline double WindCursor_drift(const WindCursor* cursor, double x, double t) {
+  if (cursor->x0 == 0) {
+    return windage(cursor->cwind, cursor->vx0, x, t);
+  }
+  double w = cursor->cwind*17.60; // in/s, as windage() converts it
+  return cursor->drift0 + w*(t - cursor->t0) + (cursor->vz0 - w)*(x - cursor->x0)/cursor->vx0;
+}
+
+/**
+ * The headwind at range x feet, at or past the current zone, e.g. at a stage of a step not yet taken.
+ */
+static inline double WindCursor_headwind_at(const WindCursor* cursor, double x) {
+  if (x < cursor->next) {
+    return cursor->hwind;
+  }
+  const WindZone* zone = cursor->zone + 1;
+  while (x >= zone[1].start) zone++;
+  return zone->headwind;
+}
+
+/**
+ * Moves the cursor over a step from range x0 feet, time t0 and downrange velocity vx0 to (x1, t1, vx1),
+ * entering each zone the step reaches at the zone's start, with the time and velocity interpolated within the
+ * step.  The bullet enters the zone with the drift and sideways velocity it carried out of the last one.
+ */
+static inline void WindCursor_advance(WindCursor* cursor, double x0, double t0, double vx0, double x1, double t1,
+                                      double vx1) {
+  while (x1 >= cursor->next) {
+    double x = cursor->next;
+    double f = x1 > x0 ? (x - x0)/(x1 - x0) : 1;
+    double t = t0 + f*(t1 - t0);
+    double vx = vx0 + f*(vx1 - vx0);
+    double w = cursor->cwind*17.60;
+    cursor->drift0 = WindCursor_drift(cursor, x, t);
+    cursor->vz0 = w + (cursor->vz0 - w)*vx/cursor->vx0;
+    cursor->vx0 = vx;
+    cursor->x0 = x;
+    cursor->t0 = t;
+    cursor->zone++;
+    cursor->next = cursor->zone[1].start;
+    cursor->hwind = cursor->zone->headwind;
+    cursor->cwind = cursor->zone->crosswind;
+  }
+}
+
+/**
+ * Stores row n of a solution.  Every integrator records through here so that they all produce identical rows
+ * for identical state.
+ * @param x     range along the line of sight, in feet
+ * @param y     path relative to the line of sight, in feet
+ * @param t     time of flight, in seconds
+ * @param v     total velocity
+ * @param vx    velocity in the bore direction
+ * @param vy    velocity perpendicular to the bore direction
+ * @param windage_inches crosswind drift, in inches
+ */
+static inline void Ballistics_record_drift(Ballistics* ballistics, int n, double x, double y, double t, double v,
+                                           double vx, double vy, double windage_inches) {
+  if (ballistics->sink) {
+    ballistics->sink->row(ballistics->sink, x, y, t, v, vx, vy, windage_inches);
+    return;
+  }
+  double* columns = ballistics->columns;
+  size_t capacity = ballistics->capacity;
+  columns[BALLISTICS_COL_RANGE*capacity + n] = x/3;
+  columns[BALLISTICS_COL_PATH*capacity + n] = y*12;
+  columns[BALLISTICS_COL_MOA*capacity + n] = -rad_to_moa(atan(y / x));
+  columns[BALLISTICS_COL_TIME*capacity + n] = t;
+  columns[BALLISTICS_COL_WINDAGE*capacity + n] = windage_inches;
+  columns[BALLISTICS_COL_WINDAGE_MOA*capacity + n] = rad_to_moa(atan((windage_inches/12) / x));
+  columns[BALLISTICS_COL_V*capacity + n] = v;
+  columns[BALLISTICS_COL_VX*capacity + n] = vx;
+  columns[BALLISTICS_COL_VY*capacity + n] = vy;
+}
+
+/**
+ * Ballistics_record_drift() with the drift of a crosswind of cwind mi/hr over the whole flight, for muzzle
+ * velocity vi.
+ */
+static inline void Ballistics_record(Ballistics* ballistics, int n, double x, double y, double t, double v,
+                                     double vx, double vy, double cwind, double vi) {
+  Ballistics_record_drift(ballistics, n, x, y, t, v, vx, vy, windage(cwind, vi, x, t));
+}
+
+#ifdef __cplusplus
+}
+#endif
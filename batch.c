@@ -0,0 +1,237 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define BATCH_LANES 8
+#define BATCH_INITIAL_ROWS 1024 // rows each solution starts with; they double as the trajectory needs them
+
+/**
+ * Work shared by every thread solving a batch.  Lanes pull inputs from it one at a time.
+ */
+typedef struct {
+  const BallisticsInput* in;
+  size_t n;
+  Ballistics** ballistics;
+  int* max_yardages;
+  atomic_size_t next; // index of the next input not yet assigned to a lane
+  atomic_int failed;  // set once a solution could not be allocated or grown
+} Batch;
+
+/**
+ * Structure-of-arrays integration state.  Lanes [0, live) are in flight.
+ */
+typedef struct {
+  double t[BATCH_LANES];
+  double x[BATCH_LANES], y[BATCH_LANES];
+  double vx[BATCH_LANES], vy[BATCH_LANES];
+  double gx[BATCH_LANES], gy[BATCH_LANES];
+  double hwind[BATCH_LANES], cwind[BATCH_LANES];
+  double vi[BATCH_LANES];
+  double drag_coefficient[BATCH_LANES];
+  DragFunction drag_function[BATCH_LANES];
+  int n[BATCH_LANES];
+  long steps[BATCH_LANES];
+  size_t input[BATCH_LANES];
+  int live;
+} Lanes;
+
+// Stops handing out inputs once memory has run out.  Ballistics_solve_batch() frees the solutions handed out.
+static void batch_fail(Batch* batch) {
+  atomic_store(&batch->failed, 1);
+  atomic_store(&batch->next, batch->n);
+}
+
+// Loads the next unassigned input into lane l.  Returns 0 once the batch is exhausted, or has failed.
+static int lane_load(Batch* batch, Lanes* lanes, int l) {
+  size_t i = atomic_fetch_add(&batch->next, 1);
+  if (i >= batch->n) return 0;
+
+  batch->ballistics[i] = Ballistics_alloc(BATCH_INITIAL_ROWS);
+  if (batch->ballistics[i] == NULL) {
+    batch_fail(batch);
+    return 0;
+  }
+
+  const BallisticsInput* in = &batch->in[i];
+  lanes->input[l] = i;
+  lanes->drag_function[l] = in->drag_function;
+  lanes->drag_coefficient[l] = in->drag_coefficient;
+  lanes->vi[l] = in->vi;
+  lanes->hwind[l] = headwind(in->wind_speed, in->wind_angle);
+  lanes->cwind[l] = crosswind(in->wind_speed, in->wind_angle);
+  lanes->gy[l] = GRAVITY*cos(deg_to_rad((in->shooting_angle + in->zero_angle)));
+  lanes->gx[l] = GRAVITY*sin(deg_to_rad((in->shooting_angle + in->zero_angle)));
+  lanes->vx[l] = in->vi * cos(deg_to_rad(in->zero_angle));
+  lanes->vy[l] = in->vi * sin(deg_to_rad(in->zero_angle));
+  lanes->t[l] = 0;
+  lanes->x[l] = 0;
+  lanes->y[l] = -in->sight_height/12;
+  lanes->n[l] = 0;
+  lanes->steps[l] = 0;
+  return 1;
+}
+
+// Moves lane `from` into slot `to`, keeping the live lanes contiguous.
+static void lane_move(Lanes* lanes, int to, int from) {
+  lanes->t[to] = lanes->t[from];
+  lanes->x[to] = lanes->x[from];
+  lanes->y[to] = lanes->y[from];
+  lanes->vx[to] = lanes->vx[from];
+  lanes->vy[to] = lanes->vy[from];
+  lanes->gx[to] = lanes->gx[from];
+  lanes->gy[to] = lanes->gy[from];
+  lanes->hwind[to] = lanes->hwind[from];
+  lanes->cwind[to] = lanes->cwind[from];
+  lanes->vi[to] = lanes->vi[from];
+  lanes->drag_coefficient[to] = lanes->drag_coefficient[from];
+  lanes->drag_function[to] = lanes->drag_function[from];
+  lanes->n[to] = lanes->n[from];
+  lanes->steps[to] = lanes->steps[from];
+  lanes->input[to] = lanes->input[from];
+}
+
+// Finishes the trajectory in lane l and refills the lane, or compacts it away when no input is left.
+static void lane_retire(Batch* batch, Lanes* lanes, int l) {
+  size_t i = lanes->input[l];
+  batch->ballistics[i]->max_yardage = lanes->n[l];
+  batch->ballistics[i]->drag_evaluations = lanes->steps[l];
+  batch->ballistics[i]->vi = lanes->vi[l];
+  if (batch->max_yardages) {
+    batch->max_yardages[i] = lanes->n[l];
+  }
+
+  if (!lane_load(batch, lanes, l)) {
+    lanes->live--;
+    if (l != lanes->live) {
+      lane_move(lanes, l, lanes->live);
+    }
+  }
+}
+
+// Integrates inputs from the batch until it is exhausted.  The per-lane arithmetic is exactly that of
+// Ballistics_solve(), so the recorded rows are bit-for-bit the same.
+static void batch_run(Batch* batch) {
+  Lanes lanes;
+  lanes.live = 0;
+  while (lanes.live < BATCH_LANES && lane_load(batch, &lanes, lanes.live)) {
+    lanes.live++;
+  }
+
+  while (lanes.live > 0 && !atomic_load_explicit(&batch->failed, memory_order_relaxed)) {
+    for (int l = 0; l < lanes.live;) {
+      double vx = lanes.vx[l], vy = lanes.vy[l];
+      double vx1 = vx, vy1 = vy;
+      double v = pow(pow(vx,2)+pow(vy,2),0.5);
+      double dt = 0.5/v;
+
+      double dv = retard(lanes.drag_function[l], lanes.drag_coefficient[l], v+lanes.hwind[l]);
+      double dvx = -(vx/v)*dv;
+      double dvy = -(vy/v)*dv;
+      lanes.steps[l]++;
+
+      vx = vx + dt*dvx + dt*lanes.gx[l];
+      vy = vy + dt*dvy + dt*lanes.gy[l];
+
+      double x = lanes.x[l];
+      double y = lanes.y[l];
+      if (x/3 >= lanes.n[l]) {
+        Ballistics* ballistics = batch->ballistics[lanes.input[l]];
+        if (lanes.n[l] == ballistics->capacity) {
+          int rows = 2*ballistics->capacity;
+          if (rows > BALLISTICS_COMPUTATION_MAX_YARDS) rows = BALLISTICS_COMPUTATION_MAX_YARDS;
+          if (Ballistics_grow(ballistics, rows) != 0) {
+            batch_fail(batch);
+            return;
+          }
+        }
+        Ballistics_record(ballistics, lanes.n[l], x, y, lanes.t[l]+dt, v, vx, vy, lanes.cwind[l], lanes.vi[l]);
+        lanes.n[l]++;
+      }
+
+      lanes.x[l] = x + dt * (vx+vx1)/2;
+      lanes.y[l] = y + dt * (vy+vy1)/2;
+      lanes.vx[l] = vx;
+      lanes.vy[l] = vy;
+      lanes.t[l] = lanes.t[l] + dt;
+
+      if (fabs(vy)>fabs(3*vx) || lanes.n[l]>=BALLISTICS_COMPUTATION_MAX_YARDS) {
+        // The lane is refilled in place, or the last live lane is moved into it; either way, revisit slot l.
+        lane_retire(batch, &lanes, l);
+        continue;
+      }
+      l++;
+    }
+  }
+}
+
+static void* batch_worker(void* arg) {
+  batch_run((Batch*)arg);
+  return NULL;
+}
+
+int Ballistics_solve_batch(const BallisticsInput* in, size_t n, Ballistics** ballistics, int* max_yardages,
+                           int threads) {
+  if (n > 0 && (in == NULL || ballistics == NULL)) {
+    return -1;
+  }
+
+  Batch batch;
+  batch.in = in;
+  batch.n = n;
+  batch.ballistics = ballistics;
+  batch.max_yardages = max_yardages;
+  atomic_init(&batch.next, 0);
+  atomic_init(&batch.failed, 0);
+  for (size_t i = 0; i < n; i++) {
+    ballistics[i] = NULL;
+  }
+
+  // The calling thread always works too, so a worker that fails to start only costs parallelism.
+  pthread_t* workers = NULL;
+  int started = 0;
+  if (threads > 1) {
+    workers = malloc(sizeof(pthread_t) * (threads - 1));
+    for (int i = 0; workers && i < threads - 1; i++) {
+      if (pthread_create(&workers[started], NULL, batch_worker, &batch) == 0) {
+        started++;
+      }
+    }
+  }
+
+  batch_run(&batch);
+
+  for (int i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+  free(workers);
+
+  if (atomic_load(&batch.failed)) {
+    for (size_t i = 0; i < n; i++) {
+      if (ballistics[i]) {
+        Ballistics_free(ballistics[i]);
+        ballistics[i] = NULL;
+      }
+    }
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,566 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// A self-contained benchmark harness for the library's hot entry points.
+//
+// Each case is timed for at least --min-time seconds and reported as ns/op, along with the integration steps
+// and heap allocations per op where they apply.  --json writes the same results in a form that can be diffed
+// across commits.  Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ballistics/ballistics.h"
+#include "solver_bench.h"
+
+// Allocation counting.  The bench links with --wrap for each allocator, so every allocation made by the
+// library and by this harness passes through these counters.
+static long allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  allocations++;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  allocations++;
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  allocations++;
+  return __real_realloc(ptr, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+  allocations++;
+  return __real_aligned_alloc(alignment, size);
+}
+
+/**
+ * A benchmark body.  Runs the operation iterations times.
+ * @return the total integration steps taken, or -1 if the operation does not report steps.
+ */
+typedef long (*BenchFunction)(const void* arg, long iterations);
+
+typedef struct {
+  char name[64];
+  BenchFunction run;
+  const void* arg;
+} BenchCase;
+
+typedef struct {
+  long iterations;
+  double ns_per_op;
+  double steps_per_op; // negative if not reported
+  double allocs_per_op;
+} BenchResult;
+
+// Keeps the compiler from discarding results.
+static volatile double sink;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+// retard(): one op is one call, cycling through velocities from 100 to 4500 ft/s.
+#define RETARD_VELOCITIES 256
+static double retard_velocities[RETARD_VELOCITIES];
+
+static long bench_retard(const void* arg, long iterations) {
+  DragFunction drag_function = *(const DragFunction*)arg;
+  double sum = 0;
+  for (long i = 0; i < iterations; i++) {
+    sum += retard(drag_function, 0.5, retard_velocities[i % RETARD_VELOCITIES]);
+  }
+  sink = sum;
+  return -1;
+}
+
+// retard_fast(), over the same velocities.
+static long bench_retard_fast(const void* arg, long iterations) {
+  DragFunction drag_function = *(const DragFunction*)arg;
+  double sum = 0;
+  for (long i = 0; i < iterations; i++) {
+    sum += retard_fast(drag_function, 0.5, retard_velocities[i % RETARD_VELOCITIES]);
+  }
+  sink = sum;
+  return -1;
+}
+
+// DragTable_retard(): one op is one call, on G7 resampled as a Cd-vs-Mach curve.
+static long bench_drag_table(const void* arg, long iterations) {
+  const DragTable* table = arg;
+  double sum = 0;
+  for (long i = 0; i < iterations; i++) {
+    sum += DragTable_retard(table, 0.5, retard_velocities[i % RETARD_VELOCITIES]);
+  }
+  sink = sum;
+  return -1;
+}
+
+typedef struct {
+  DragFunction drag_function;
+  double drag_coefficient;
+  double vi;
+  double zero_range;
+} ZeroArgs;
+
+static long bench_zero_angle(const void* arg, long iterations) {
+  const ZeroArgs* z = arg;
+  for (long i = 0; i < iterations; i++) {
+    sink = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  }
+  return -1;
+}
+
+static long bench_solve(const void* arg, long iterations) {
+  const ZeroArgs* z = arg;
+  double angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  long steps = 0;
+  for (long i = 0; i < iterations; i++) {
+    Ballistics* solution;
+    Ballistics_solve(&solution, z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, angle, 10, 90);
+    steps += Ballistics_get_drag_evaluations(solution);
+    sink = Ballistics_get_path(solution, 500);
+    Ballistics_free(solution);
+  }
+  return steps;
+}
+
+// bench_solve() with BALLISTICS_MATH_FAST.
+static long bench_solve_fast(const void* arg, long iterations) {
+  const ZeroArgs* z = arg;
+  BallisticsInput in = {z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, 0, 10, 90};
+  in.zero_angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  BallisticsOptions options = {0};
+  options.math = BALLISTICS_MATH_FAST;
+  long steps = 0;
+  for (long i = 0; i < iterations; i++) {
+    Ballistics* solution;
+    Ballistics_solve_ex(&solution, &in, &options);
+    steps += Ballistics_get_drag_evaluations(solution);
+    sink = Ballistics_get_path(solution, 500);
+    Ballistics_free(solution);
+  }
+  return steps;
+}
+
+static long bench_pbr(const void* arg, long iterations) {
+  const ZeroArgs* z = arg;
+  for (long i = 0; i < iterations; i++) {
+    struct PBR* pbr;
+    if (PBR_solve(&pbr, z->drag_function, z->drag_coefficient, z->vi, 1.6, 6) == 0) {
+      sink = PBR_get_max_PBR_yards(pbr);
+      PBR_free(pbr);
+    }
+  }
+  return -1;
+}
+
+static long bench_pbr_root(const void* arg, long iterations) {
+  const ZeroArgs* z = arg;
+  BallisticsOptions options = {0};
+  options.pbr_method = PBR_METHOD_ROOT;
+  for (long i = 0; i < iterations; i++) {
+    struct PBR* pbr;
+    if (PBR_solve_ex(&pbr, z->drag_function, z->drag_coefficient, z->vi, 1.6, 6, &options) == 0) {
+      sink = PBR_get_max_PBR_yards(pbr);
+      PBR_free(pbr);
+    }
+  }
+  return -1;
+}
+
+// The 4/6/8/10 inch table for one load; one op is the whole table.
+static long bench_pbr_many(const void* arg, long iterations) {
+  static const double sizes[] = {4, 6, 8, 10};
+  const ZeroArgs* z = arg;
+  for (long i = 0; i < iterations; i++) {
+    struct PBR* pbr[4];
+    PBR_solve_many(z->drag_function, z->drag_coefficient, z->vi, 1.6, sizes, 4, pbr);
+    for (int k = 0; k < 4; k++) {
+      if (pbr[k]) {
+        sink = PBR_get_max_PBR_yards(pbr[k]);
+        PBR_free(pbr[k]);
+      }
+    }
+  }
+  return -1;
+}
+
+// ballistics::Solver<T> out to 1000 yards; the solver rides on the case's argument.
+typedef struct {
+  const ZeroArgs* load;
+  BenchSolver solver;
+} SolverArgs;
+
+static long bench_solver(const void* arg, long iterations) {
+  static double angle = -1; // zeroed once, so that only the solves are timed and counted
+  const SolverArgs* s = arg;
+  const ZeroArgs* z = s->load;
+  if (angle < 0) {
+    angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  }
+  BallisticsInput in = {z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, angle, 10, 90};
+  double path;
+  long steps = bench_solver_1000_yards(&in, s->solver, iterations, &path);
+  sink = path;
+  return steps;
+}
+
+// A 1000 yard trajectory fitted at the default tolerances, then read at every yard.
+static long bench_trajectory(const void* arg, long iterations) {
+  const ZeroArgs* z = arg;
+  BallisticsInput in = {z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, 0, 10, 90};
+  in.zero_angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  double row[BALLISTICS_COLUMNS];
+  for (long i = 0; i < iterations; i++) {
+    Trajectory* trajectory = Trajectory_solve(1000, &in, NULL, 0, 0);
+    for (int yard = 0; yard <= 1000; yard++) {
+      Trajectory_at_range(trajectory, yard, row);
+    }
+    sink = row[BALLISTICS_COL_PATH];
+    Trajectory_free(trajectory);
+  }
+  return -1;
+}
+
+// One round followed through its flight at 240 Hz with a cursor; one op is one frame.
+static long bench_state_at_time(const void* arg, long iterations) {
+  static Ballistics* solution = NULL; // solved once, so that only the lookups are timed and counted
+  const ZeroArgs* z = arg;
+  if (solution == NULL) {
+    double angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+    BallisticsInput in = {z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, angle, 10, 90};
+    solution = Ballistics_create(1000);
+    Ballistics_solve_into(solution, 1000, &in, NULL);
+  }
+  double flight = Ballistics_get_time(solution, Ballistics_get_max_yardage(solution) - 1);
+  BallisticsTimeCursor cursor = {0};
+  double row[BALLISTICS_COLUMNS];
+  double t = 0;
+  for (long i = 0; i < iterations; i++) {
+    t += 1.0/240;
+    if (t > flight) {
+      t = 0;
+      cursor.row = 0;
+    }
+    Ballistics_state_at_time(solution, t, &cursor, row);
+    sink = row[BALLISTICS_COL_PATH];
+  }
+  return 0; // no integration
+}
+
+// Sweeping the wind on a solved trajectory; one op recomputes windage at every yard.
+static long bench_update_crosswind(const void* arg, long iterations) {
+  static Ballistics* solution = NULL; // solved once, so that only the updates are timed and counted
+  const ZeroArgs* z = arg;
+  if (solution == NULL) {
+    double angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+    Ballistics_solve(&solution, z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, angle, 10, 90);
+  }
+  for (long i = 0; i < iterations; i++) {
+    Ballistics_update_crosswind(solution, (i & 31)*0.5, 90);
+    sink = Ballistics_get_windage(solution, 500);
+  }
+  return 0; // no integration
+}
+
+// Truing both parameters to 7 impacts from 300 to 1000 yards, starting 5% off; one op is the whole fit.
+static long bench_truing(const void* arg, long iterations) {
+  static const double ranges[] = {300, 400, 500, 600, 700, 800, 1000};
+  const ZeroArgs* z = arg;
+  BallisticsInput in = {z->drag_function, z->drag_coefficient, z->vi, 1.6, 0, 0, 0, 0};
+  in.zero_angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  Ballistics* solution = Ballistics_create(1);
+  Ballistics_solve_ranges(solution, ranges, 7, &in, NULL);
+  BallisticsTruingObservation observations[7];
+  for (int i = 0; i < 7; i++) {
+    observations[i].range = ranges[i];
+    observations[i].path = Ballistics_get_path(solution, i);
+    observations[i].sd = 0;
+  }
+  Ballistics_free(solution);
+
+  BallisticsTruing truing = {0};
+  truing.input = in;
+  truing.input.drag_coefficient *= 1.05;
+  truing.input.vi *= 1.05;
+  truing.zero_range = z->zero_range;
+  truing.observations = observations;
+  truing.observation_count = 7;
+  for (long i = 0; i < iterations; i++) {
+    BallisticsTruingResult result;
+    Ballistics_truing(&truing, NULL, &result, NULL);
+    sink = result.drag_coefficient;
+  }
+  return -1;
+}
+
+static long bench_atmosphere(const void* arg, long iterations) {
+  (void)arg;
+  double sum = 0;
+  for (long i = 0; i < iterations; i++) {
+    sum += atmosphere_correction(0.5, (i & 1023)*10.0, 29.53, 59, 0.78);
+  }
+  sink = sum;
+  return -1;
+}
+
+// A 100 shot dispersion study at 100 to 1000 yards on the calling thread; one op is the whole study.
+static long bench_monte_carlo(const void* arg, long iterations) {
+  static const double ranges[] = {100, 200, 300, 400, 500, 600, 700, 800, 900, 1000};
+  static double angle = -1; // zeroed once, so that only the study is timed and counted
+  const ZeroArgs* z = arg;
+  if (angle < 0) {
+    angle = zero_angle(z->drag_function, z->drag_coefficient, z->vi, 1.6, z->zero_range, 0);
+  }
+  BallisticsMonteCarlo mc = {0};
+  mc.input.drag_function = z->drag_function;
+  mc.input.drag_coefficient = z->drag_coefficient;
+  mc.input.vi = z->vi;
+  mc.input.sight_height = 1.6;
+  mc.input.zero_angle = angle;
+  mc.input.wind_speed = 10;
+  mc.input.wind_angle = 90;
+  mc.vi_sd = 10;
+  mc.drag_coefficient_sd = 0.02;
+  mc.wind_speed_sd = 2;
+  mc.wind_angle_sd = 15;
+  mc.range_sd = 0.02;
+  mc.ranges = ranges;
+  mc.range_count = 10;
+  mc.target_width = 12;
+  mc.target_height = 12;
+  mc.samples = 100;
+  BallisticsMonteCarloRange out[10];
+  for (long i = 0; i < iterations; i++) {
+    mc.seed = i;
+    Ballistics_monte_carlo(&mc, NULL, out);
+    sink = out[9].p_hit;
+  }
+  return -1;
+}
+
+// Sums the integration steps of instrumented calls, for operations that do not report their own.
+static void count_steps(const BallisticsStats* stats, void* context) {
+  *(long*)context += stats->steps;
+}
+
+static BenchResult bench_run(const BenchCase* c, double min_time) {
+  BenchResult r;
+  long iterations = 1;
+
+  // Grow the iteration count until a run is long enough to time, then size the final run from it.
+  for (;;) {
+    double start = now_ns();
+    c->run(c->arg, iterations);
+    double elapsed = now_ns() - start;
+    if (elapsed >= min_time*1e8 || iterations >= (1L << 40)) {
+      double target = min_time*1e9 / (elapsed / iterations);
+      if (target > iterations) iterations = (long)target;
+      break;
+    }
+    iterations *= elapsed > 0 ? (elapsed < min_time*1e7 ? 10 : 2) : 10;
+  }
+
+  long allocs = allocations;
+  double start = now_ns();
+  long steps = c->run(c->arg, iterations);
+  double elapsed = now_ns() - start;
+
+  r.iterations = iterations;
+  r.ns_per_op = elapsed / iterations;
+  r.allocs_per_op = (double)(allocations - allocs) / iterations;
+  if (steps < 0) {
+    // Untimed, so that the callback does not skew ns/op.  Stays -1 without BALLISTICS_INSTRUMENTATION.
+    long counted = 0;
+    Ballistics_set_stats_callback(count_steps, &counted);
+    c->run(c->arg, 1);
+    Ballistics_set_stats_callback(NULL, NULL);
+    if (counted > 0) steps = counted*iterations;
+  }
+  r.steps_per_op = steps < 0 ? -1 : (double)steps / iterations;
+  return r;
+}
+
+static const char* drag_names[] = {"", "G1", "G2", "G3", "G4", "G5", "G6", "G7", "G8"};
+static const DragFunction drag_functions[] = {G1, G2, G3, G4, G5, G6, G7, G8};
+
+static const ZeroArgs zeros[] = {
+  {G1, 0.5, 2800, 100},
+  {G1, 0.5, 2800, 200},
+  {G1, 0.5, 2800, 300},
+};
+
+static const ZeroArgs loads[] = {
+  {G1, 0.25, 1200, 50},
+  {G1, 0.5, 2800, 100},
+  {G1, 0.7, 3200, 200},
+  {G7, 0.2, 2600, 100},
+  {G7, 0.35, 3000, 200},
+};
+
+#define MAX_CASES 64
+
+static int add_case(BenchCase* cases, int n, BenchFunction run, const void* arg, const char* format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  vsnprintf(cases[n].name, sizeof(cases[n].name), format, ap);
+  va_end(ap);
+  cases[n].run = run;
+  cases[n].arg = arg;
+  return n + 1;
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr, "usage: %s [--filter SUBSTRING] [--min-time SECONDS] [--json FILE]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+  const char* filter = NULL;
+  const char* json_path = NULL;
+  double min_time = 0.2;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    }
+    else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      min_time = atof(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    }
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  for (int i = 0; i < RETARD_VELOCITIES; i++) {
+    retard_velocities[i] = 100 + i*(4400.0/(RETARD_VELOCITIES - 1));
+  }
+
+  BenchCase cases[MAX_CASES];
+  int n = 0;
+  for (int i = 0; i < 8; i++) {
+    n = add_case(cases, n, bench_retard, &drag_functions[i], "retard/%s", drag_names[drag_functions[i]]);
+  }
+  for (int i = 0; i < 8; i++) {
+    n = add_case(cases, n, bench_retard_fast, &drag_functions[i], "retard_fast/%s", drag_names[drag_functions[i]]);
+  }
+  double mach[200], cd[200];
+  for (int i = 0; i < 200; i++) {
+    mach[i] = 0.05 + i*0.025;
+    double v = mach[i]*DRAG_TABLE_SPEED_OF_SOUND;
+    cd[i] = retard(G7, 1, v) / (v*v*DRAG_TABLE_RETARDATION);
+  }
+  DragTable* g7_table = DragTable_create(mach, cd, 200);
+  n = add_case(cases, n, bench_drag_table, g7_table, "DragTable_retard/G7");
+  for (int i = 0; i < (int)(sizeof(zeros)/sizeof(zeros[0])); i++) {
+    n = add_case(cases, n, bench_zero_angle, &zeros[i], "zero_angle/%.0fyd", zeros[i].zero_range);
+  }
+  for (int i = 0; i < (int)(sizeof(loads)/sizeof(loads[0])); i++) {
+    n = add_case(cases, n, bench_solve, &loads[i], "Ballistics_solve/%s/bc%.2f/%.0ffps",
+                 drag_names[loads[i].drag_function], loads[i].drag_coefficient, loads[i].vi);
+  }
+  for (int i = 0; i < (int)(sizeof(loads)/sizeof(loads[0])); i++) {
+    n = add_case(cases, n, bench_solve_fast, &loads[i], "Ballistics_solve/fast/%s/bc%.2f/%.0ffps",
+                 drag_names[loads[i].drag_function], loads[i].drag_coefficient, loads[i].vi);
+  }
+  for (int i = 0; i < (int)(sizeof(loads)/sizeof(loads[0])); i++) {
+    n = add_case(cases, n, bench_pbr, &loads[i], "PBR_solve/%s/bc%.2f/%.0ffps",
+                 drag_names[loads[i].drag_function], loads[i].drag_coefficient, loads[i].vi);
+  }
+  for (int i = 0; i < (int)(sizeof(loads)/sizeof(loads[0])); i++) {
+    n = add_case(cases, n, bench_pbr_root, &loads[i], "PBR_solve_ex/root/%s/bc%.2f/%.0ffps",
+                 drag_names[loads[i].drag_function], loads[i].drag_coefficient, loads[i].vi);
+  }
+  for (int i = 0; i < (int)(sizeof(loads)/sizeof(loads[0])); i++) {
+    n = add_case(cases, n, bench_pbr_many, &loads[i], "PBR_solve_many/4-10in/%s/bc%.2f/%.0ffps",
+                 drag_names[loads[i].drag_function], loads[i].drag_coefficient, loads[i].vi);
+  }
+  static const char* const solver_names[] = {"double", "double_sqrt", "float"};
+  SolverArgs solvers[3];
+  for (int i = 0; i < 3; i++) {
+    solvers[i].load = &loads[4];
+    solvers[i].solver = (BenchSolver)i;
+    n = add_case(cases, n, bench_solver, &solvers[i], "Solver/%s/1000yd/%s/bc%.2f/%.0ffps", solver_names[i],
+                 drag_names[loads[4].drag_function], loads[4].drag_coefficient, loads[4].vi);
+  }
+  n = add_case(cases, n, bench_monte_carlo, &loads[4], "Ballistics_monte_carlo/100/%s/bc%.2f/%.0ffps",
+               drag_names[loads[4].drag_function], loads[4].drag_coefficient, loads[4].vi);
+  n = add_case(cases, n, bench_trajectory, &loads[4], "Trajectory_solve/1000yd/%s/bc%.2f/%.0ffps",
+               drag_names[loads[4].drag_function], loads[4].drag_coefficient, loads[4].vi);
+  n = add_case(cases, n, bench_state_at_time, &loads[4], "Ballistics_state_at_time/240Hz/%s/bc%.2f/%.0ffps",
+               drag_names[loads[4].drag_function], loads[4].drag_coefficient, loads[4].vi);
+  n = add_case(cases, n, bench_update_crosswind, &loads[4], "Ballistics_update_crosswind/%s/bc%.2f/%.0ffps",
+               drag_names[loads[4].drag_function], loads[4].drag_coefficient, loads[4].vi);
+  n = add_case(cases, n, bench_truing, &loads[4], "Ballistics_truing/7pt/%s/bc%.2f/%.0ffps",
+               drag_names[loads[4].drag_function], loads[4].drag_coefficient, loads[4].vi);
+  n = add_case(cases, n, bench_atmosphere, NULL, "atmosphere_correction");
+
+  FILE* json = NULL;
+  if (json_path) {
+    json = fopen(json_path, "w");
+    if (json == NULL) {
+      perror(json_path);
+      return 1;
+    }
+    fprintf(json, "{\n  \"benchmarks\": [");
+  }
+
+  printf("%-40s %14s %12s %12s %12s\n", "benchmark", "iterations", "ns/op", "steps/op", "allocs/op");
+  int written = 0;
+  for (int i = 0; i < n; i++) {
+    if (filter && strstr(cases[i].name, filter) == NULL) {
+      continue;
+    }
+    BenchResult r = bench_run(&cases[i], min_time);
+
+    printf("%-40s %14ld %12.1f ", cases[i].name, r.iterations, r.ns_per_op);
+    if (r.steps_per_op < 0) printf("%12s ", "-"); else printf("%12.1f ", r.steps_per_op);
+    printf("%12.2f\n", r.allocs_per_op);
+    fflush(stdout);
+
+    if (json) {
+      fprintf(json, "%s\n    {\"name\": \"%s\", \"iterations\": %ld, \"ns_per_op\": %.3f, ", written ? "," : "",
+              cases[i].name, r.iterations, r.ns_per_op);
+      if (r.steps_per_op < 0) fprintf(json, "\"steps_per_op\": null, ");
+      else fprintf(json, "\"steps_per_op\": %.3f, ", r.steps_per_op);
+      fprintf(json, "\"allocs_per_op\": %.3f}", r.allocs_per_op);
+    }
+    written++;
+  }
+
+  DragTable_free(g7_table);
+  if (json) {
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+  }
+  return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Solver<T> cases for bench.c, which is C.  Solver<double> keeps the C engine's historical speed expression,
+// pow(pow(vx,2)+pow(vy,2),0.5), while Solver<float> takes sqrt(); SqrtMath gives the double solver sqrt() too,
+// so that the float case can be compared like for like.
+
+#include "solver_bench.h"
+#include "ballistics/solver.hpp"
+
+namespace {
+  struct SqrtMath {
+    template <typename T>
+    static T pow(T x, T y) { return std::pow(x, y); }
+    template <typename T>
+    static T speed(T vx, T vy) { return std::sqrt(vx*vx + vy*vy); }
+  };
+
+  template <typename T, typename Math>
+  long solve_1000_yards(const BallisticsInput* in, long iterations, double* path) {
+    static ballistics::Row<T> rows[1001];
+    ballistics::Solver<T, Math> solver(*in);
+    long steps = 0;
+    for (long i = 0; i < iterations; i++) {
+      long n;
+      solver.solve(rows, 1001, &n);
+      steps += n;
+      *path = rows[500].path;
+    }
+    return steps;
+  }
+}
+
+long bench_solver_1000_yards(const BallisticsInput* in, BenchSolver solver, long iterations, double* path) {
+  switch (solver) {
+    case BENCH_SOLVER_DOUBLE: return solve_1000_yards<double, ballistics::ExactMath>(in, iterations, path);
+    case BENCH_SOLVER_DOUBLE_SQRT: return solve_1000_yards<double, SqrtMath>(in, iterations, path);
+    case BENCH_SOLVER_FLOAT: return solve_1000_yards<float, ballistics::ExactMath>(in, iterations, path);
+  }
+  return -1;
+}
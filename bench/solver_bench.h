@@ -0,0 +1,40 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "ballistics/ballistics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  BENCH_SOLVER_DOUBLE,      // Solver<double>, as Ballistics_solve() runs it
+  BENCH_SOLVER_DOUBLE_SQRT, // Solver<double> with sqrt() for the speed, as Solver<float> has
+  BENCH_SOLVER_FLOAT        // Solver<float>
+} BenchSolver;
+
+/**
+ * Solves yards 0 through 1000 of in iterations times with solver, into rows allocated once.
+ * @param path receives the path at 500 yards, so that the solves cannot be discarded
+ * @return the total integration steps taken
+ */
+long bench_solver_1000_yards(const BallisticsInput* in, BenchSolver solver, long iterations, double* path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,380 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define CACHE_STRIPES 16
+#define CACHE_KEY_FIELDS 17
+
+typedef enum {
+  CACHE_ZERO = 1,
+  CACHE_SOLVE
+} CacheKind;
+
+/**
+ * Quantized inputs.  Unused fields are zero.
+ */
+typedef struct {
+  int64_t q[CACHE_KEY_FIELDS];
+} CacheKey;
+
+typedef struct CacheEntry {
+  CacheKey key;
+  uint64_t hash;
+  double angle;          // CACHE_ZERO
+  Ballistics* solution;  // CACHE_SOLVE; the cache holds one reference
+  struct CacheEntry* chain;          // next entry in the same bucket
+  struct CacheEntry* newer;          // LRU list, most recent at the head
+  struct CacheEntry* older;
+} CacheEntry;
+
+/**
+ * One lock's share of the cache: a chained hash table threaded with an LRU list.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  CacheEntry** buckets;
+  size_t mask;       // bucket count - 1
+  size_t size;
+  size_t capacity;
+  CacheEntry* newest;
+  CacheEntry* oldest;
+} CacheStripe;
+
+struct BallisticsCache {
+  CacheStripe stripes[CACHE_STRIPES];
+  atomic_ulong hits;
+  atomic_ulong misses;
+  atomic_ulong evictions;
+};
+
+static int64_t quantize(double value, double step) {
+  return (int64_t)llround(value / step);
+}
+
+static double dequantize(int64_t q, double step) {
+  return q * step;
+}
+
+static int64_t bits(double value) {
+  int64_t b;
+  memcpy(&b, &value, sizeof(b));
+  return b;
+}
+
+static double unbits(int64_t b) {
+  double value;
+  memcpy(&value, &b, sizeof(value));
+  return value;
+}
+
+// FNV-1a over the key's bytes.
+static uint64_t cache_hash(const CacheKey* key) {
+  const unsigned char* p = (const unsigned char*)key->q;
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < sizeof(key->q); i++) {
+    h = (h ^ p[i]) * 1099511628211ULL;
+  }
+  return h;
+}
+
+static void cache_unlink(CacheStripe* stripe, CacheEntry* e) {
+  if (e->newer) e->newer->older = e->older; else stripe->newest = e->older;
+  if (e->older) e->older->newer = e->newer; else stripe->oldest = e->newer;
+}
+
+static void cache_push_newest(CacheStripe* stripe, CacheEntry* e) {
+  e->newer = NULL;
+  e->older = stripe->newest;
+  if (stripe->newest) stripe->newest->newer = e; else stripe->oldest = e;
+  stripe->newest = e;
+}
+
+// Looks up key with the stripe locked, marking a hit as most recently used.
+static CacheEntry* cache_find(CacheStripe* stripe, const CacheKey* key, uint64_t hash) {
+  for (CacheEntry* e = stripe->buckets[hash & stripe->mask]; e; e = e->chain) {
+    if (e->hash == hash && memcmp(&e->key, key, sizeof(*key)) == 0) {
+      cache_unlink(stripe, e);
+      cache_push_newest(stripe, e);
+      return e;
+    }
+  }
+  return NULL;
+}
+
+static void cache_entry_free(CacheEntry* e) {
+  if (e->solution) {
+    Ballistics_free(e->solution);
+  }
+  free(e);
+}
+
+// Inserts e with the stripe locked, evicting the least recently used entry if the stripe is full.
+// The evicted entry is returned so that it can be released after the lock is dropped.
+static CacheEntry* cache_insert(BallisticsCache* cache, CacheStripe* stripe, CacheEntry* e) {
+  CacheEntry** bucket = &stripe->buckets[e->hash & stripe->mask];
+  e->chain = *bucket;
+  *bucket = e;
+  cache_push_newest(stripe, e);
+
+  if (++stripe->size <= stripe->capacity) {
+    return NULL;
+  }
+
+  CacheEntry* victim = stripe->oldest;
+  cache_unlink(stripe, victim);
+  CacheEntry** link = &stripe->buckets[victim->hash & stripe->mask];
+  while (*link != victim) {
+    link = &(*link)->chain;
+  }
+  *link = victim->chain;
+  stripe->size--;
+  atomic_fetch_add_explicit(&cache->evictions, 1, memory_order_relaxed);
+  return victim;
+}
+
+BallisticsCache* BallisticsCache_create(size_t capacity) {
+  BallisticsCache* cache = calloc(1, sizeof(BallisticsCache));
+  if (cache == NULL) {
+    return NULL;
+  }
+
+  // Split capacity exactly, so that the stripes together never hold more than it.
+  size_t per_stripe = capacity / CACHE_STRIPES;
+  size_t buckets = 1;
+  while (buckets < 2*(per_stripe + 1)) buckets <<= 1;
+
+  for (int i = 0; i < CACHE_STRIPES; i++) {
+    CacheStripe* stripe = &cache->stripes[i];
+    pthread_mutex_init(&stripe->lock, NULL);
+    stripe->buckets = calloc(buckets, sizeof(CacheEntry*));
+    stripe->mask = buckets - 1;
+    stripe->capacity = per_stripe + ((size_t)i < capacity % CACHE_STRIPES);
+    if (stripe->buckets == NULL) {
+      BallisticsCache_free(cache);
+      return NULL;
+    }
+  }
+  atomic_init(&cache->hits, 0);
+  atomic_init(&cache->misses, 0);
+  atomic_init(&cache->evictions, 0);
+  return cache;
+}
+
+void BallisticsCache_free(BallisticsCache* cache) {
+  for (int i = 0; i < CACHE_STRIPES; i++) {
+    CacheStripe* stripe = &cache->stripes[i];
+    for (CacheEntry* e = stripe->newest; e;) {
+      CacheEntry* older = e->older;
+      cache_entry_free(e);
+      e = older;
+    }
+    free(stripe->buckets);
+    pthread_mutex_destroy(&stripe->lock);
+  }
+  free(cache);
+}
+
+// Returns the entry for key, computing it with compute() outside the lock on a miss.  Zero angles are returned
+// through angle, and solutions through solution with a reference taken for the caller.
+static int cache_get(BallisticsCache* cache, const CacheKey* key, int (*compute)(const CacheKey*, CacheEntry*),
+                     double* angle, Ballistics** solution) {
+  uint64_t hash = cache_hash(key);
+  CacheStripe* stripe = &cache->stripes[(hash >> 32) % CACHE_STRIPES];
+
+  pthread_mutex_lock(&stripe->lock);
+  CacheEntry* e = cache_find(stripe, key, hash);
+  if (e) {
+    *angle = e->angle;
+    *solution = e->solution ? Ballistics_retain(e->solution) : NULL;
+    pthread_mutex_unlock(&stripe->lock);
+    atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+    return 0;
+  }
+  pthread_mutex_unlock(&stripe->lock);
+  atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+
+  CacheEntry* fresh = calloc(1, sizeof(CacheEntry));
+  if (fresh == NULL) {
+    return -1;
+  }
+  fresh->key = *key;
+  fresh->hash = hash;
+  if (compute(key, fresh) != 0) {
+    cache_entry_free(fresh);
+    return -1;
+  }
+
+  // Another thread may have computed the same entry meanwhile; keep the first one so that every caller
+  // shares a single solution.
+  CacheEntry* victim = NULL;
+  pthread_mutex_lock(&stripe->lock);
+  e = cache_find(stripe, key, hash);
+  if (e == NULL) {
+    victim = cache_insert(cache, stripe, fresh);
+    e = fresh;
+    fresh = NULL;
+  }
+  *angle = e->angle;
+  *solution = e->solution ? Ballistics_retain(e->solution) : NULL;
+  pthread_mutex_unlock(&stripe->lock);
+
+  if (fresh) cache_entry_free(fresh);
+  if (victim) cache_entry_free(victim);
+  return 0;
+}
+
+// Key layouts.  Both end with the options that change results.
+enum {
+  K_KIND, K_DRAG, K_BC, K_VI, K_SIGHT,
+  // zero angles
+  K_ZERO_RANGE = 5, K_Y_INTERCEPT,
+  // solutions
+  K_SHOOTING_ANGLE = 5, K_ZERO_ANGLE, K_WIND_SPEED, K_WIND_ANGLE, K_MAX_YARDS,
+  // options
+  K_DRAG_MODE = 10, K_ENGINE_OR_METHOD, K_TOLERANCE, K_DRAG_TABLE, K_ATMOSPHERE, K_WIND, K_MATH
+};
+
+static void key_options(CacheKey* key, const BallisticsOptions* options, CacheKind kind) {
+  if (options == NULL) return;
+  key->q[K_DRAG_MODE] = options->drag_mode;
+  key->q[K_DRAG_TABLE] = (int64_t)(intptr_t)options->drag_table;
+  key->q[K_ATMOSPHERE] = (int64_t)(intptr_t)options->atmosphere;
+  key->q[K_WIND] = (int64_t)(intptr_t)options->wind;
+  key->q[K_MATH] = options->math;
+  if (kind == CACHE_ZERO) {
+    key->q[K_ENGINE_OR_METHOD] = options->zero_method;
+    key->q[K_TOLERANCE] = bits(options->zero_tolerance);
+  }
+  else {
+    key->q[K_ENGINE_OR_METHOD] = options->engine;
+    key->q[K_TOLERANCE] = bits(options->tolerance);
+  }
+}
+
+static BallisticsOptions key_to_options(const CacheKey* key) {
+  BallisticsOptions options;
+  memset(&options, 0, sizeof(options));
+  options.drag_mode = (DragMode)key->q[K_DRAG_MODE];
+  options.drag_table = (const DragTable*)(intptr_t)key->q[K_DRAG_TABLE];
+  options.atmosphere = (const AtmosphereProfile*)(intptr_t)key->q[K_ATMOSPHERE];
+  options.wind = (const WindProfile*)(intptr_t)key->q[K_WIND];
+  options.math = (BallisticsMath)key->q[K_MATH];
+  if (key->q[K_KIND] == CACHE_ZERO) {
+    options.zero_method = (ZeroMethod)key->q[K_ENGINE_OR_METHOD];
+    options.zero_tolerance = unbits(key->q[K_TOLERANCE]);
+  }
+  else {
+    options.engine = (BallisticsEngine)key->q[K_ENGINE_OR_METHOD];
+    options.tolerance = unbits(key->q[K_TOLERANCE]);
+  }
+  return options;
+}
+
+static int compute_zero(const CacheKey* key, CacheEntry* e) {
+  BallisticsOptions options = key_to_options(key);
+  ZeroResult result;
+  int status = zero_angle_ex((DragFunction)key->q[K_DRAG],
+                             dequantize(key->q[K_BC], BALLISTICS_CACHE_BC_STEP),
+                             dequantize(key->q[K_VI], BALLISTICS_CACHE_VELOCITY_STEP),
+                             dequantize(key->q[K_SIGHT], BALLISTICS_CACHE_INCHES_STEP),
+                             dequantize(key->q[K_ZERO_RANGE], BALLISTICS_CACHE_YARDS_STEP),
+                             dequantize(key->q[K_Y_INTERCEPT], BALLISTICS_CACHE_INCHES_STEP),
+                             &options, &result);
+  e->angle = result.angle;
+  return status;
+}
+
+double BallisticsCache_zero_angle(BallisticsCache* cache, DragFunction drag_function, double drag_coefficient,
+                                  double vi, double sight_height, double zero_range, double y_intercept,
+                                  const BallisticsOptions* options) {
+  CacheKey key;
+  memset(&key, 0, sizeof(key));
+  key.q[K_KIND] = CACHE_ZERO;
+  key.q[K_DRAG] = drag_function;
+  key.q[K_BC] = quantize(drag_coefficient, BALLISTICS_CACHE_BC_STEP);
+  key.q[K_VI] = quantize(vi, BALLISTICS_CACHE_VELOCITY_STEP);
+  key.q[K_SIGHT] = quantize(sight_height, BALLISTICS_CACHE_INCHES_STEP);
+  key.q[K_ZERO_RANGE] = quantize(zero_range, BALLISTICS_CACHE_YARDS_STEP);
+  key.q[K_Y_INTERCEPT] = quantize(y_intercept, BALLISTICS_CACHE_INCHES_STEP);
+  key_options(&key, options, CACHE_ZERO);
+
+  double angle = NAN;
+  Ballistics* unused;
+  cache_get(cache, &key, compute_zero, &angle, &unused);
+  return angle;
+}
+
+static int compute_solve(const CacheKey* key, CacheEntry* e) {
+  BallisticsOptions options = key_to_options(key);
+  BallisticsInput in;
+  in.drag_function = (DragFunction)key->q[K_DRAG];
+  in.drag_coefficient = dequantize(key->q[K_BC], BALLISTICS_CACHE_BC_STEP);
+  in.vi = dequantize(key->q[K_VI], BALLISTICS_CACHE_VELOCITY_STEP);
+  in.sight_height = dequantize(key->q[K_SIGHT], BALLISTICS_CACHE_INCHES_STEP);
+  in.shooting_angle = dequantize(key->q[K_SHOOTING_ANGLE], BALLISTICS_CACHE_ANGLE_STEP);
+  in.zero_angle = dequantize(key->q[K_ZERO_ANGLE], BALLISTICS_CACHE_ANGLE_STEP);
+  in.wind_speed = dequantize(key->q[K_WIND_SPEED], BALLISTICS_CACHE_WIND_STEP);
+  in.wind_angle = dequantize(key->q[K_WIND_ANGLE], BALLISTICS_CACHE_ANGLE_STEP);
+
+  size_t max_yards = (size_t)key->q[K_MAX_YARDS];
+  e->solution = Ballistics_create(max_yards);
+  if (e->solution == NULL || Ballistics_solve_into(e->solution, max_yards, &in, &options) < 0) {
+    return -1;
+  }
+  return 0;
+}
+
+Ballistics* BallisticsCache_solve(BallisticsCache* cache, size_t max_yards, const BallisticsInput* in,
+                                  const BallisticsOptions* options) {
+  if (max_yards >= BALLISTICS_COMPUTATION_MAX_YARDS) {
+    max_yards = BALLISTICS_COMPUTATION_MAX_YARDS - 1;
+  }
+
+  CacheKey key;
+  memset(&key, 0, sizeof(key));
+  key.q[K_KIND] = CACHE_SOLVE;
+  key.q[K_DRAG] = in->drag_function;
+  key.q[K_BC] = quantize(in->drag_coefficient, BALLISTICS_CACHE_BC_STEP);
+  key.q[K_VI] = quantize(in->vi, BALLISTICS_CACHE_VELOCITY_STEP);
+  key.q[K_SIGHT] = quantize(in->sight_height, BALLISTICS_CACHE_INCHES_STEP);
+  key.q[K_SHOOTING_ANGLE] = quantize(in->shooting_angle, BALLISTICS_CACHE_ANGLE_STEP);
+  key.q[K_ZERO_ANGLE] = quantize(in->zero_angle, BALLISTICS_CACHE_ANGLE_STEP);
+  key.q[K_WIND_SPEED] = quantize(in->wind_speed, BALLISTICS_CACHE_WIND_STEP);
+  key.q[K_WIND_ANGLE] = quantize(in->wind_angle, BALLISTICS_CACHE_ANGLE_STEP);
+  key.q[K_MAX_YARDS] = (int64_t)max_yards;
+  key_options(&key, options, CACHE_SOLVE);
+
+  double unused;
+  Ballistics* solution = NULL;
+  if (cache_get(cache, &key, compute_solve, &unused, &solution) != 0) {
+    return NULL;
+  }
+  return solution;
+}
+
+void BallisticsCache_get_stats(BallisticsCache* cache, BallisticsCacheStats* stats) {
+  stats->hits = atomic_load_explicit(&cache->hits, memory_order_relaxed);
+  stats->misses = atomic_load_explicit(&cache->misses, memory_order_relaxed);
+  stats->evictions = atomic_load_explicit(&cache->evictions, memory_order_relaxed);
+}
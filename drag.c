@@ -0,0 +1,260 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics/ballistics.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+// fdlibm's split of ln(2) and its log/exp polynomial coefficients.
+#define LN2_HI  6.93147180369123816490e-01
+#define LN2_LO  1.90821492927058770002e-10
+#define INV_LN2 1.44269504088896338700e+00
+#define LOG_LG1 6.666666666666735130e-01
+#define LOG_LG2 3.999999999940941908e-01
+#define LOG_LG3 2.857142874366239149e-01
+#define LOG_LG4 2.222219843214978396e-01
+#define LOG_LG5 1.818357216161805012e-01
+#define LOG_LG6 1.531383769920937332e-01
+#define LOG_LG7 1.479819860511658591e-01
+#define EXP_P1  1.66666666666666019037e-01
+#define EXP_P2 -2.77777777770155933842e-03
+#define EXP_P3  6.61375632143793436117e-05
+#define EXP_P4 -1.65339022054652515390e-06
+#define EXP_P5  4.13813679705723846039e-08
+#define EXP_SHIFTER 6755399441055744.0 // 1.5 * 2^52
+
+#define DRAG_MAX_SEGMENTS 41
+
+/**
+ * A drag function's segments as arrays, for indexed lookup.  Entry [segments] is a sentinel that lanes
+ * below every threshold gather harmlessly before being masked out.
+ */
+typedef struct {
+  int segments;
+  double threshold[DRAG_MAX_SEGMENTS];
+  double acceleration[DRAG_MAX_SEGMENTS + 1];
+  double mass[DRAG_MAX_SEGMENTS + 1];
+} DragCoefficients;
+
+#define DRAG_COUNT(threshold, a, m) + 1
+#define DRAG_THRESHOLD(threshold, a, m) threshold,
+#define DRAG_ACCELERATION(threshold, a, m) a,
+#define DRAG_MASS(threshold, a, m) m,
+#define DRAG_COEFFICIENTS(name) { \
+    0 DRAG_##name##_SEGMENTS(DRAG_COUNT), \
+    { DRAG_##name##_SEGMENTS(DRAG_THRESHOLD) }, \
+    { DRAG_##name##_SEGMENTS(DRAG_ACCELERATION) }, \
+    { DRAG_##name##_SEGMENTS(DRAG_MASS) } }
+
+static const DragCoefficients drag_g1 = DRAG_COEFFICIENTS(G1);
+static const DragCoefficients drag_g2 = DRAG_COEFFICIENTS(G2);
+static const DragCoefficients drag_g5 = DRAG_COEFFICIENTS(G5);
+static const DragCoefficients drag_g6 = DRAG_COEFFICIENTS(G6);
+static const DragCoefficients drag_g7 = DRAG_COEFFICIENTS(G7);
+static const DragCoefficients drag_g8 = DRAG_COEFFICIENTS(G8);
+
+// G3 and G4 have no coefficients, so every lane falls through to the sentinel and comes back -1.
+static const DragCoefficients drag_none = { 0, { 0 }, { 0 }, { 0 } };
+
+static const DragCoefficients* drag_coefficients(DragFunction drag_function) {
+  switch (drag_function) {
+    case G1: return &drag_g1;
+    case G2: return &drag_g2;
+    case G5: return &drag_g5;
+    case G6: return &drag_g6;
+    case G7: return &drag_g7;
+    case G8: return &drag_g8;
+    default: return &drag_none;
+  }
+}
+
+#define KERNEL_WIDTH 2
+#define KERNEL_NAME(x) x##_generic
+#define KERNEL_TARGET
+#include "drag_kernel.h"
+#undef KERNEL_WIDTH
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DRAG_HAVE_X86 1
+
+#define KERNEL_WIDTH 4
+#define KERNEL_NAME(x) x##_avx2
+#define KERNEL_TARGET __attribute__((target("avx2,fma")))
+#include "drag_kernel.h"
+#undef KERNEL_WIDTH
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+
+#define KERNEL_WIDTH 8
+#define KERNEL_NAME(x) x##_avx512
+#define KERNEL_TARGET __attribute__((target("avx512f,avx512dq")))
+#include "drag_kernel.h"
+#undef KERNEL_WIDTH
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#endif
+
+static int isa_supported(DragIsa isa) {
+  switch (isa) {
+    case DRAG_ISA_GENERIC:
+      return 1;
+#ifdef DRAG_HAVE_X86
+    case DRAG_ISA_AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case DRAG_ISA_AVX512:
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+#endif
+    default:
+      return 0;
+  }
+}
+
+static DragIsa best_isa;
+static pthread_once_t best_isa_once = PTHREAD_ONCE_INIT;
+
+static void best_isa_init(void) {
+#ifdef DRAG_HAVE_X86
+  __builtin_cpu_init();
+#endif
+  best_isa = isa_supported(DRAG_ISA_AVX512) ? DRAG_ISA_AVX512
+           : isa_supported(DRAG_ISA_AVX2) ? DRAG_ISA_AVX2
+           : DRAG_ISA_GENERIC;
+}
+
+DragIsa retard_v_best_isa(void) {
+  pthread_once(&best_isa_once, best_isa_init);
+  return best_isa;
+}
+
+int retard_v_isa(DragIsa isa, DragFunction drag_function, const double* drag_coefficient, const double* vp,
+                 double* out, size_t n) {
+  retard_v_best_isa(); // initializes the CPU feature probe
+  if (!isa_supported(isa)) {
+    return -1;
+  }
+
+  const DragCoefficients* table = drag_coefficients(drag_function);
+  switch (isa) {
+#ifdef DRAG_HAVE_X86
+    case DRAG_ISA_AVX512:
+      retard_kernel_avx512(table, drag_coefficient, vp, out, n);
+      break;
+    case DRAG_ISA_AVX2:
+      retard_kernel_avx2(table, drag_coefficient, vp, out, n);
+      break;
+#endif
+    default:
+      retard_kernel_generic(table, drag_coefficient, vp, out, n);
+      break;
+  }
+  return 0;
+}
+
+void retard_v(DragFunction drag_function, const double* drag_coefficient, const double* vp, double* out, size_t n) {
+  retard_v_isa(retard_v_best_isa(), drag_function, drag_coefficient, vp, out, n);
+}
+
+// Retardation tables.  Cell k covers [k, k+1) * DRAG_TABLE_STEP fps and holds the cubic Hermite interpolant,
+// in powers of the cell-local coordinate, of the segment that owns the cell, so interpolation never straddles
+// a discontinuity between segments.  Cells that contain a segment threshold, or lie below DRAG_TABLE_MIN_FPS
+// where a cubic fits vp^mass poorly, hold NaN and defer to retard().
+#define DRAG_TABLE_STEP 2.0
+#define DRAG_TABLE_MIN_FPS 100.0
+#define DRAG_TABLE_CELLS 5000 // 10000 fps / DRAG_TABLE_STEP
+
+typedef struct {
+  double c[4];
+} DragCell;
+
+static _Alignas(64) DragCell drag_tables[G8 + 1][DRAG_TABLE_CELLS];
+static pthread_once_t drag_tables_once[G8 + 1] = {
+  PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT,
+  PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT
+};
+
+static void drag_table_build(DragFunction drag_function) {
+  const DragCoefficients* table = drag_coefficients(drag_function);
+  DragCell* cells = drag_tables[drag_function];
+
+  for (int k = 0; k < DRAG_TABLE_CELLS; k++) {
+    double v0 = k * DRAG_TABLE_STEP;
+    double v1 = v0 + DRAG_TABLE_STEP;
+
+    int split = v0 < DRAG_TABLE_MIN_FPS;
+    int segment = 0;
+    for (int s = 0; s < table->segments; s++) {
+      if (table->threshold[s] >= v0 && table->threshold[s] < v1) split = 1;
+      if (v0 + DRAG_TABLE_STEP/2 <= table->threshold[s]) segment++;
+    }
+    if (split) {
+      cells[k].c[0] = cells[k].c[1] = cells[k].c[2] = cells[k].c[3] = NAN;
+      continue;
+    }
+
+    double a = table->acceleration[segment];
+    double m = table->mass[segment];
+    double f0 = a * pow(v0, m);
+    double f1 = a * pow(v1, m);
+    double d0 = m * f0 / v0 * DRAG_TABLE_STEP; // derivatives with respect to the cell-local coordinate
+    double d1 = m * f1 / v1 * DRAG_TABLE_STEP;
+    cells[k].c[0] = f0;
+    cells[k].c[1] = d0;
+    cells[k].c[2] = 3*(f1 - f0) - 2*d0 - d1;
+    cells[k].c[3] = 2*(f0 - f1) + d0 + d1;
+  }
+}
+
+#define DRAG_TABLE_INIT(name) static void drag_table_init_##name(void) { drag_table_build(name); }
+DRAG_TABLE_INIT(G1)
+DRAG_TABLE_INIT(G2)
+DRAG_TABLE_INIT(G5)
+DRAG_TABLE_INIT(G6)
+DRAG_TABLE_INIT(G7)
+DRAG_TABLE_INIT(G8)
+
+static const DragCell* drag_table(DragFunction drag_function) {
+  switch (drag_function) {
+    case G1: pthread_once(&drag_tables_once[G1], drag_table_init_G1); break;
+    case G2: pthread_once(&drag_tables_once[G2], drag_table_init_G2); break;
+    case G5: pthread_once(&drag_tables_once[G5], drag_table_init_G5); break;
+    case G6: pthread_once(&drag_tables_once[G6], drag_table_init_G6); break;
+    case G7: pthread_once(&drag_tables_once[G7], drag_table_init_G7); break;
+    case G8: pthread_once(&drag_tables_once[G8], drag_table_init_G8); break;
+    default: return NULL;
+  }
+  return drag_tables[drag_function];
+}
+
+double retard_table(DragFunction drag_function, double drag_coefficient, double vp) {
+  const DragCell* cells = drag_table(drag_function);
+  if (cells == NULL || !(vp > 0 && vp < 10000)) {
+    return -1;
+  }
+
+  double u = vp * (1 / DRAG_TABLE_STEP);
+  int k = (int)u;
+  u -= k;
+  const double* c = cells[k].c;
+  if (isnan(c[0])) {
+    return retard(drag_function, drag_coefficient, vp);
+  }
+  return (c[0] + u*(c[1] + u*(c[2] + u*c[3]))) / drag_coefficient;
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The retard_v() kernel, written once over GCC vector extensions and instantiated by drag.c for each
+// vector width.  Before including, define:
+//   KERNEL_WIDTH   the number of doubles per vector
+//   KERNEL_NAME(x) x suffixed with the instantiation's name
+//   KERNEL_TARGET  the function attribute selecting the instruction set (may be empty)
+
+#define vd KERNEL_NAME(vd)
+#define vi KERNEL_NAME(vi)
+
+typedef double vd __attribute__((vector_size(KERNEL_WIDTH * sizeof(double))));
+typedef int64_t vi __attribute__((vector_size(KERNEL_WIDTH * sizeof(double))));
+
+// Natural logarithm of positive, finite, normal lanes; the fdlibm reduction and polynomial.
+static KERNEL_TARGET inline vd KERNEL_NAME(vlog)(vd x) {
+  vi bits = (vi)x;
+  vi e = ((bits >> 52) & 0x7ff) - 1023;
+  vd m = (vd)((bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL); // [1, 2)
+
+  // Center the mantissa on 1 so that |f| < sqrt(2)-1.
+  vi big = m > M_SQRT2;
+  m = (vd)(((vi)m & ~big) | ((vi)(m * 0.5) & big));
+  e = e - big;
+
+  vd f = m - 1;
+  vd k = __builtin_convertvector(e, vd);
+  vd s = f / (2 + f);
+  vd z = s * s;
+  vd w = z * z;
+  vd t1 = w * (LOG_LG2 + w * (LOG_LG4 + w * LOG_LG6));
+  vd t2 = z * (LOG_LG1 + w * (LOG_LG3 + w * (LOG_LG5 + w * LOG_LG7)));
+  vd r = t1 + t2;
+  vd hfsq = 0.5 * f * f;
+  return k * LN2_HI - ((hfsq - (s * (hfsq + r) + k * LN2_LO)) - f);
+}
+
+// Exponential of lanes in [-700, 700]; the fdlibm reduction and polynomial.
+static KERNEL_TARGET inline vd KERNEL_NAME(vexp)(vd x) {
+  // Round x/ln(2) to the nearest integer with the 1.5*2^52 shifter.
+  vd shifted = x * INV_LN2 + EXP_SHIFTER;
+  vi k = (vi)shifted - (vi)((vd){} + EXP_SHIFTER);
+  vd kd = shifted - EXP_SHIFTER;
+
+  vd r = (x - kd * LN2_HI) - kd * LN2_LO;
+  vd rr = r * r;
+  vd c = r - rr * (EXP_P1 + rr * (EXP_P2 + rr * (EXP_P3 + rr * (EXP_P4 + rr * EXP_P5))));
+  vd y = 1 - ((r * c) / (c - 2) - r);
+  return (vd)((vi)y + (k << 52));
+}
+
+static KERNEL_TARGET void KERNEL_NAME(retard_kernel)(const DragCoefficients* table, const double* drag_coefficient,
+                                                    const double* vp, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + KERNEL_WIDTH <= n; i += KERNEL_WIDTH) {
+    vd v, bc;
+    memcpy(&v, vp + i, sizeof(v));
+    memcpy(&bc, drag_coefficient + i, sizeof(bc));
+
+    // Every threshold v does not exceed pushes it one segment further down the table.
+    vi segment = (vi){};
+    for (int s = 0; s < table->segments; s++) {
+      segment -= v <= table->threshold[s];
+    }
+
+    vd acceleration, mass;
+    for (int l = 0; l < KERNEL_WIDTH; l++) {
+      acceleration[l] = table->acceleration[segment[l]];
+      mass[l] = table->mass[segment[l]];
+    }
+
+    // Invalid lanes are computed on a harmless velocity and replaced with -1 afterwards.
+    vi valid = (v > 0) & (v < 10000) & (segment < table->segments);
+    vd safe = (vd)(((vi)v & valid) | ((vi)((vd){} + 1) & ~valid));
+    vd r = acceleration * KERNEL_NAME(vexp)(mass * KERNEL_NAME(vlog)(safe)) / bc;
+    r = (vd)(((vi)r & valid) | ((vi)((vd){} - 1) & ~valid));
+    memcpy(out + i, &r, sizeof(r));
+  }
+
+  // Pad the remainder out to a full vector rather than falling back to pow(), so every lane is computed alike.
+  if (i < n) {
+    double v[KERNEL_WIDTH], bc[KERNEL_WIDTH], r[KERNEL_WIDTH];
+    for (int l = 0; l < KERNEL_WIDTH; l++) {
+      v[l] = i + l < n ? vp[i + l] : 1;
+      bc[l] = i + l < n ? drag_coefficient[i + l] : 1;
+    }
+    KERNEL_NAME(retard_kernel)(table, bc, v, r, KERNEL_WIDTH);
+    memcpy(out + i, r, sizeof(double) * (n - i));
+  }
+}
+
+#undef vd
+#undef vi
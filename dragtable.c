@@ -0,0 +1,140 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Fritsch & Carlson, "Monotone Piecewise Cubic Interpolation" (1980): secant slopes, with the tangents
+// limited so that the cubic never overshoots between points.
+static void monotone_tangents(const double* x, const double* y, size_t n, double* m) {
+  for (size_t k = 0; k + 1 < n; k++) {
+    m[k] = (y[k+1] - y[k]) / (x[k+1] - x[k]);
+  }
+  double last = m[n-2];
+  for (size_t k = n - 2; k > 0; k--) {
+    double left = m[k-1], right = m[k];
+    m[k] = left*right <= 0 ? 0 : (left + right)/2;
+  }
+  m[n-1] = last;
+
+  for (size_t k = 0; k + 1 < n; k++) {
+    double secant = (y[k+1] - y[k]) / (x[k+1] - x[k]);
+    if (secant == 0) {
+      m[k] = m[k+1] = 0;
+      continue;
+    }
+    double a = m[k]/secant, b = m[k+1]/secant;
+    double r = a*a + b*b;
+    if (r > 9) {
+      double tau = 3/sqrt(r);
+      m[k] = tau*a*secant;
+      m[k+1] = tau*b*secant;
+    }
+  }
+}
+
+DragTable* DragTable_create(const double* mach, const double* cd, size_t n) {
+  if (n < 2) {
+    return NULL;
+  }
+  for (size_t k = 0; k < n; k++) {
+    if (!isfinite(mach[k]) || !isfinite(cd[k]) || cd[k] < 0 || (k > 0 && !(mach[k] > mach[k-1]))) {
+      return NULL;
+    }
+  }
+
+  int points = (int)ceil((mach[n-1] - mach[0]) / DRAG_TABLE_MACH_STEP) + 1;
+  DragTable* table = malloc(sizeof(DragTable) + sizeof(double)*points);
+  double* m = malloc(sizeof(double)*n);
+  if (table == NULL || m == NULL) {
+    free(table);
+    free(m);
+    return NULL;
+  }
+  monotone_tangents(mach, cd, n, m);
+
+  table->mach0 = mach[0];
+  table->inv_step = 1/DRAG_TABLE_MACH_STEP;
+  table->points = points;
+  size_t k = 0;
+  for (int i = 0; i < points; i++) {
+    double x = fmin(mach[0] + i*DRAG_TABLE_MACH_STEP, mach[n-1]);
+    while (k + 2 < n && x > mach[k+1]) {
+      k++;
+    }
+    // Cubic Hermite on [mach[k], mach[k+1]].
+    double h = mach[k+1] - mach[k];
+    double t = (x - mach[k]) / h;
+    double t2 = t*t, t3 = t2*t;
+    table->cd[i] = (2*t3 - 3*t2 + 1)*cd[k] + (t3 - 2*t2 + t)*h*m[k]
+                 + (-2*t3 + 3*t2)*cd[k+1] + (t3 - t2)*h*m[k+1];
+  }
+
+  free(m);
+  return table;
+}
+
+DragTable* DragTable_load_csv(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return NULL;
+  }
+
+  size_t n = 0, capacity = 0;
+  double* mach = NULL;
+  double* cd = NULL;
+  char line[256];
+  int ok = 1;
+  while (ok && fgets(line, sizeof(line), file)) {
+    double x, y;
+    if (sscanf(line, " %lf%*[ ,;\t]%lf", &x, &y) != 2) {
+      continue;
+    }
+    if (n == capacity) {
+      capacity = capacity ? 2*capacity : 64;
+      double* grown_mach = realloc(mach, sizeof(double)*capacity);
+      if (grown_mach) mach = grown_mach;
+      double* grown_cd = realloc(cd, sizeof(double)*capacity);
+      if (grown_cd) cd = grown_cd;
+      ok = grown_mach && grown_cd;
+      if (!ok) break;
+    }
+    mach[n] = x;
+    cd[n] = y;
+    n++;
+  }
+  fclose(file);
+
+  DragTable* table = ok ? DragTable_create(mach, cd, n) : NULL;
+  free(mach);
+  free(cd);
+  return table;
+}
+
+void DragTable_free(DragTable* table) {
+  free(table);
+}
+
+double DragTable_cd(const DragTable* table, double mach) {
+  return DragTable_lookup(table, mach);
+}
+
+double DragTable_retard(const DragTable* table, double drag_coefficient, double vp) {
+  return DragTable_retard_inline(table, drag_coefficient, vp);
+}
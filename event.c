@@ -0,0 +1,163 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+/**
+ * An event as a test on one column.  With the sign s of the event, it is reached at the first row where
+ * s*column <= s*value, searching from row first, or from the maximum of s*column past it.
+ */
+typedef struct {
+  BallisticsColumn column;
+  double s;     // 1 for an event reached from above, -1 from below
+  int extremum; // search from the maximum of s*column
+  int first;
+} EventColumn;
+
+static const EventColumn event_columns[] = {
+  [BALLISTICS_EVENT_VELOCITY] = {BALLISTICS_COL_V,    1, 0, 0},
+  [BALLISTICS_EVENT_PATH]     = {BALLISTICS_COL_PATH, 1, 1, 0},
+  // The angle at the muzzle row, at no range at all, is only the sight height over nothing.
+  [BALLISTICS_EVENT_MOA]      = {BALLISTICS_COL_MOA, -1, 1, 1},
+  [BALLISTICS_EVENT_TIME]     = {BALLISTICS_COL_TIME, -1, 0, 0},
+};
+
+static const EventColumn* EventColumn_get(BallisticsEvent event) {
+  if (event < 0 || event >= (int)(sizeof(event_columns)/sizeof(event_columns[0]))) {
+    return NULL;
+  }
+  return &event_columns[event];
+}
+
+static inline int EventColumn_reached(const EventColumn* event, double c, double value) {
+  return event->s*c <= event->s*value;
+}
+
+// The range where the column reaches value between a row at range r0 and the next, at r1.
+static inline double EventColumn_crossing(double r0, double c0, double r1, double c1, double value) {
+  return r0 + (value - c0)/(c1 - c0)*(r1 - r0);
+}
+
+double Ballistics_find_event(Ballistics* ballistics, BallisticsEvent event, double value) {
+  const EventColumn* e = EventColumn_get(event);
+  int n = ballistics->max_yardage;
+  if (e == NULL || e->first >= n) {
+    return -1;
+  }
+  const double* c = Ballistics_column(ballistics, e->column);
+  const double* range = Ballistics_column(ballistics, BALLISTICS_COL_RANGE);
+
+  int lo = e->first;
+  if (e->extremum) {
+    int hi = n - 1;
+    while (lo < hi) {
+      int mid = lo + (hi - lo)/2;
+      if (e->s*c[mid] < e->s*c[mid+1]) lo = mid + 1; else hi = mid;
+    }
+  }
+  if (EventColumn_reached(e, c[lo], value)) {
+    return range[lo];
+  }
+  int hi = n - 1;
+  if (!EventColumn_reached(e, c[hi], value)) {
+    return -1;
+  }
+  while (hi - lo > 1) {
+    int mid = lo + (hi - lo)/2;
+    if (EventColumn_reached(e, c[mid], value)) hi = mid; else lo = mid;
+  }
+  return EventColumn_crossing(range[lo], c[lo], range[hi], c[hi], value);
+}
+
+/**
+ * Watches the rows of a solve for an event, keeping only the previous row, and stops the integrator once the
+ * event is found.  Follows Ballistics_find_event() row for row, so the two agree exactly.
+ */
+typedef struct {
+  BallisticsRowSink sink;
+  const EventColumn* event;
+  double value;
+  BallisticsSamples* samples;
+  int rows;
+  int searching; // past the extremum
+  double previous, previous_range;
+  double range;
+} EventWatch;
+
+static void EventWatch_found(EventWatch* watch, double range) {
+  watch->range = range;
+  watch->samples->count = watch->rows;
+}
+
+static void EventWatch_row(BallisticsRowSink* sink, double x, double y, double t, double v, double vx, double vy,
+                           double windage_inches) {
+  (void)vx; (void)vy; (void)windage_inches;
+  EventWatch* watch = (EventWatch*)sink;
+  const EventColumn* e = watch->event;
+  double c;
+  switch (e->column) {
+    case BALLISTICS_COL_V: c = v; break;
+    case BALLISTICS_COL_PATH: c = y*12; break;
+    case BALLISTICS_COL_MOA: c = -rad_to_moa(atan(y / x)); break;
+    default: c = t; break;
+  }
+  double range = x/3;
+  int row = watch->rows++;
+
+  if (row == e->first && !e->extremum) {
+    watch->searching = 1;
+    if (EventColumn_reached(e, c, watch->value)) {
+      EventWatch_found(watch, range);
+      return;
+    }
+  }
+  else if (row > e->first && !watch->searching && e->s*watch->previous >= e->s*c) {
+    // The previous row was the extremum.
+    watch->searching = 1;
+    if (EventColumn_reached(e, watch->previous, watch->value)) {
+      EventWatch_found(watch, watch->previous_range);
+      return;
+    }
+  }
+  if (row > e->first && watch->searching && EventColumn_reached(e, c, watch->value)) {
+    EventWatch_found(watch, EventColumn_crossing(watch->previous_range, watch->previous, range, c, watch->value));
+    return;
+  }
+  watch->previous = c;
+  watch->previous_range = range;
+}
+
+double Ballistics_solve_event(BallisticsEvent event, double value, size_t max_yards, const BallisticsInput* in,
+                              const BallisticsOptions* options) {
+  const EventColumn* e = EventColumn_get(event);
+  if (e == NULL) {
+    return -1;
+  }
+  int rows = max_yards < BALLISTICS_COMPUTATION_MAX_YARDS ? (int)max_yards + 1 : BALLISTICS_COMPUTATION_MAX_YARDS;
+  BallisticsSamples samples = {NULL, 0, 1, rows, 1};
+  EventWatch watch = {{EventWatch_row}, e, value, &samples, 0, 0, 0, 0, -1};
+  Ballistics shell = {0};
+  shell.refs = 1;
+  shell.sink = &watch.sink;
+  Ballistics_integrate(&shell, &samples, in, options);
+
+  // A column still rising at the last row has its maximum there.
+  if (watch.range < 0 && e->extremum && !watch.searching && watch.rows > e->first &&
+      EventColumn_reached(e, watch.previous, value)) {
+    watch.range = watch.previous_range;
+  }
+  return watch.range;
+}
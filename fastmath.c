@@ -0,0 +1,217 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics/fastmath.h"
+
+// Generated with 50 digit decimal arithmetic and rounded to nearest; see include/ballistics/fastmath.h.
+
+const double fast_log2_table[256][2] = {
+  {0x1.ff007fc01ff00p-1, 0x1.70f83ff0a761dp-9}, {0x1.fd04794a10e6ap-1, 0x1.143068125dd31p-7},
+  {0x1.fb0c610d5e939p-1, 0x1.cb6c3abd14553p-7}, {0x1.f9182b6813bafp-1, 0x1.40f9786685d2ep-6},
+  {0x1.f727cce5f530ap-1, 0x1.9be2f7749acd1p-6}, {0x1.f53b3a3fa204ep-1, 0x1.f6734acf86969p-6},
+  {0x1.f3526859b8cecp-1, 0x1.2855905ca70f6p-5}, {0x1.f16d4c4401f17p-1, 0x1.554592bb8cd54p-5},
+  {0x1.ef8bdb389ebadp-1, 0x1.820a01ac754c5p-5}, {0x1.edae0a9b3d3a5p-1, 0x1.aea3316095f7ap-5},
+  {0x1.ebd3cff850b0cp-1, 0x1.db1175160f3b0p-5}, {0x1.e9fd21044e799p-1, 0x1.03aa8f8dc8548p-4},
+  {0x1.e829f39aef509p-1, 0x1.19b74069f5f0ap-4}, {0x1.e65a3dbe74d6bp-1, 0x1.2faef55ccb371p-4},
+  {0x1.e48df596f3394p-1, 0x1.4591d6310d85bp-4}, {0x1.e2c511719ee16p-1, 0x1.5b600a40bd4efp-4},
+  {0x1.e0ff87c01e100p-1, 0x1.7119b876bea80p-4}, {0x1.df3d4f17de4dbp-1, 0x1.86bf07507a0c7p-4},
+  {0x1.dd7e5e316d94cp-1, 0x1.9c501cdf75872p-4}, {0x1.dbc2abe7d71d4p-1, 0x1.b1cd1ecae66ebp-4},
+  {0x1.da0a2f3803b41p-1, 0x1.c73632513bd52p-4}, {0x1.d854df401d855p-1, 0x1.dc8b7c49a1ddap-4},
+  {0x1.d6a2b33ef7448p-1, 0x1.f1cd21257e188p-4}, {0x1.d4f3a293769cap-1, 0x1.037da278f2870p-3},
+  {0x1.d347a4bc01d34p-1, 0x1.0e0b05ac848f0p-3}, {0x1.d19eb155f08a4p-1, 0x1.188ecbd1d16bcp-3},
+  {0x1.cff8c01cff8c0p-1, 0x1.2309065d29792p-3}, {0x1.ce55c8eac7900p-1, 0x1.2d79c6937efe0p-3},
+  {0x1.ccb5c3b636e3ap-1, 0x1.37e11d8b10f8cp-3}, {0x1.cb18a8930de60p-1, 0x1.423f1c2c12ea2p-3},
+  {0x1.c97e6fb15e44dp-1, 0x1.4c93d33151b23p-3}, {0x1.c7e7115d0ce95p-1, 0x1.56df5328d58c3p-3},
+  {0x1.c65285fd56843p-1, 0x1.6121ac74813d2p-3}, {0x1.c4c0c61456a8ep-1, 0x1.6b5aef4aae7dfp-3},
+  {0x1.c331ca3e91679p-1, 0x1.758b2bb6c7b74p-3}, {0x1.c1a58b327f576p-1, 0x1.7fb27199df16ep-3},
+  {0x1.c01c01c01c01cp-1, 0x1.89d0d0ab430cdp-3}, {0x1.be9526d0769fap-1, 0x1.93e6587910443p-3},
+  {0x1.bd10f365451b6p-1, 0x1.9df31868c11d6p-3}, {0x1.bb8f609879493p-1, 0x1.a7f71fb7bab9fp-3},
+  {0x1.ba10679bd8488p-1, 0x1.b1f27d7bd7a82p-3}, {0x1.b89401b89401cp-1, 0x1.bbe540a3f036cp-3},
+  {0x1.b71a284ee6b34p-1, 0x1.c5cf77f860826p-3}, {0x1.b5a2d4d5b081fp-1, 0x1.cfb1321b8c3ffp-3},
+  {0x1.b42e00da17007p-1, 0x1.d98a7d8a605a5p-3}, {0x1.b2bba5ff26a23p-1, 0x1.e35b689cd2654p-3},
+  {0x1.b14bbdfd760e6p-1, 0x1.ed2401865df53p-3}, {0x1.afde42a2cb482p-1, 0x1.f6e456567fe55p-3},
+  {0x1.ae732dd1c2a09p-1, 0x1.004e3a7c97cbep-2}, {0x1.ad0a798177693p-1, 0x1.0526359bab1b2p-2},
+  {0x1.aba41fbd2e5b1p-1, 0x1.09fa235ba201fp-2}, {0x1.aa401aa401aa4p-1, 0x1.0eca0a7e91e0bp-2},
+  {0x1.a8de64688ebabp-1, 0x1.1395f1b5b61a7p-2}, {0x1.a77ef750a56dap-1, 0x1.185ddfa1a7ecep-2},
+  {0x1.a621cdb4f8fdfp-1, 0x1.1d21dad295632p-2}, {0x1.a4c6e200d2637p-1, 0x1.21e1e9c877639p-2},
+  {0x1.a36e2eb1c432dp-1, 0x1.269e12f346e2bp-2}, {0x1.a217ae575ff2fp-1, 0x1.2b565cb3313b6p-2},
+  {0x1.a0c35b92ecdf1p-1, 0x1.300acd58cbb0ep-2}, {0x1.9f713117200d0p-1, 0x1.34bb6b2546217p-2},
+  {0x1.9e2129a7d5f0ap-1, 0x1.39683c4a9ce9ap-2}, {0x1.9cd34019cd340p-1, 0x1.3e1146ebc9ff2p-2},
+  {0x1.9b876f5262dd1p-1, 0x1.42b6911cf5464p-2}, {0x1.9a3db2474fb98p-1, 0x1.475820e3a4250p-2},
+  {0x1.98f603fe670a0p-1, 0x1.4bf5fc36e8576p-2}, {0x1.97b05f8d56652p-1, 0x1.509028ff8e0a2p-2},
+  {0x1.966cc01966cc0p-1, 0x1.5526ad18493cep-2}, {0x1.952b20d73ee97p-1, 0x1.59b98e4de271dp-2},
+  {0x1.93eb7d0aa6759p-1, 0x1.5e48d25f62ab8p-2}, {0x1.92add0064ab74p-1, 0x1.62d47efe3ebeep-2},
+  {0x1.9172152b841ddp-1, 0x1.675c99ce81f91p-2}, {0x1.903847ea1cec1p-1, 0x1.6be12866f820ep-2},
+  {0x1.8f0063c018f00p-1, 0x1.7062305156d1fp-2}, {0x1.8dca64397e408p-1, 0x1.74dfb70a66387p-2},
+  {0x1.8c9644f01efbcp-1, 0x1.7959c202292f1p-2}, {0x1.8b64018b64019p-1, 0x1.7dd0569c04bfep-2},
+  {0x1.8a3395c018a34p-1, 0x1.82437a2ee70f5p-2}, {0x1.8904fd503744bp-1, 0x1.86b332056db02p-2},
+  {0x1.87d8340ab6e97p-1, 0x1.8b1f835e0b641p-2}, {0x1.86ad35cb59a84p-1, 0x1.8f88736b2d4e8p-2},
+  {0x1.8583fe7a7c018p-1, 0x1.93ee07535f968p-2}, {0x1.845c8a0ce5129p-1, 0x1.98504431717fdp-2},
+  {0x1.8336d48397a24p-1, 0x1.9caf2f1498fa2p-2}, {0x1.8212d9eba4018p-1, 0x1.a10acd0095ab5p-2},
+  {0x1.80f0965dfabcbp-1, 0x1.a56322edd3733p-2}, {0x1.7fd005ff40180p-1, 0x1.a9b835c98c709p-2},
+  {0x1.7eb124ffa053bp-1, 0x1.ae0a0a75ea863p-2}, {0x1.7d93ef9aa4b46p-1, 0x1.b258a5ca28606p-2},
+  {0x1.7c7862170949fp-1, 0x1.b6a40c92b203fp-2}, {0x1.7b5e78c693733p-1, 0x1.baec439144dffp-2},
+  {0x1.7a463005e918cp-1, 0x1.bf314f7d0f6bap-2}, {0x1.792f843c689c3p-1, 0x1.c3733502d04f7p-2},
+  {0x1.781a71dc01782p-1, 0x1.c7b1f8c4f51a3p-2}, {0x1.7706f5610d8d0p-1, 0x1.cbed9f5bb886ap-2},
+  {0x1.75f50b522b17cp-1, 0x1.d0262d554051bp-2}, {0x1.74e4b040174e5p-1, 0x1.d45ba735baa4ep-2},
+  {0x1.73d5e0c5899f7p-1, 0x1.d88e11777b147p-2}, {0x1.72c899870f91fp-1, 0x1.dcbd708b17358p-2},
+  {0x1.71bcd732e940ap-1, 0x1.e0e9c8d782cbep-2}, {0x1.70b29680e66fap-1, 0x1.e5131eba2b930p-2},
+  {0x1.6fa9d43244380p-1, 0x1.e939768714a33p-2}, {0x1.6ea28d118b474p-1, 0x1.ed5cd488f1732p-2},
+  {0x1.6d9cbdf26eaefp-1, 0x1.f17d3d01407b0p-2}, {0x1.6c9863b1ab429p-1, 0x1.f59ab4286576dp-2},
+  {0x1.6b957b34e7803p-1, 0x1.f9b53e2dc34c4p-2}, {0x1.6a94016a94017p-1, 0x1.fdccdf37d594bp-2},
+  {0x1.6993f349cc726p-1, 0x1.00f0cdb224e66p-1}, {0x1.68954dd2390bap-1, 0x1.02f9bb640c151p-1},
+  {0x1.67980e0bf08c7p-1, 0x1.05013ab7ce0e7p-1}, {0x1.669c31075ab40p-1, 0x1.07074daf563b3p-1},
+  {0x1.65a1b3dd13357p-1, 0x1.090bf64859a08p-1}, {0x1.64a893adcd25fp-1, 0x1.0b0f367c629fep-1},
+  {0x1.63b0cda236e1cp-1, 0x1.0d111040dc8fcp-1}, {0x1.62ba5eeade65ep-1, 0x1.0f1185871f2b0p-1},
+  {0x1.61c544c0161c5p-1, 0x1.1110983c79da0p-1}, {0x1.60d17c61da198p-1, 0x1.130e4a4a3ed28p-1},
+  {0x1.5fdf0317b5c6fp-1, 0x1.150a9d95ce142p-1}, {0x1.5eedd630a9fb3p-1, 0x1.17059400a03ccp-1},
+  {0x1.5dfdf303137b6p-1, 0x1.18ff2f6851398p-1}, {0x1.5d0f56ec91e57p-1, 0x1.1af771a6aad1cp-1},
+  {0x1.5c21ff51ef005p-1, 0x1.1cee5c91af102p-1}, {0x1.5b35e99f06714p-1, 0x1.1ee3f1fba2859p-1},
+  {0x1.5a4b1346add2bp-1, 0x1.20d833b3166c9p-1}, {0x1.596179c29d2cep-1, 0x1.22cb2382f2a7ep-1},
+  {0x1.58791a9357ccep-1, 0x1.24bcc3327fa0ep-1}, {0x1.5791f34015792p-1, 0x1.26ad14857003fp-1},
+  {0x1.56ac0156ac015p-1, 0x1.289c193bea5cbp-1}, {0x1.55c7426b79286p-1, 0x1.2a89d31292921p-1},
+  {0x1.54e3b4194ce66p-1, 0x1.2c7643c29342dp-1}, {0x1.5401540154015p-1, 0x1.2e616d01a702ap-1},
+  {0x1.53201fcb02fb1p-1, 0x1.304b508221788p-1}, {0x1.5240152401524p-1, 0x1.3233eff2f85fep-1},
+  {0x1.516131c015161p-1, 0x1.341b4cffcc6aap-1}, {0x1.508373590ec9cp-1, 0x1.36016950f2073p-1},
+  {0x1.4fa6d7aeb597cp-1, 0x1.37e6468b7a08fp-1}, {0x1.4ecb5c86b3d24p-1, 0x1.39c9e6513a34cp-1},
+  {0x1.4df0ffac83c01p-1, 0x1.3bac4a40d5b1ep-1}, {0x1.4d17bef15cb4ep-1, 0x1.3d8d73f5c55dbp-1},
+  {0x1.4c3f982c20723p-1, 0x1.3f6d650860074p-1}, {0x1.4b68893948d1cp-1, 0x1.414c1f0de28d1p-1},
+  {0x1.4a928ffad5b5cp-1, 0x1.4329a39877e38p-1}, {0x1.49bdaa583b401p-1, 0x1.4505f43740febp-1},
+  {0x1.48e9d63e504d1p-1, 0x1.46e112765ca4ep-1}, {0x1.4817119f3d325p-1, 0x1.48baffdeef270p-1},
+  {0x1.47455a726abf2p-1, 0x1.4a93bdf72a00bp-1}, {0x1.4674aeb4717e9p-1, 0x1.4c6b4e42535f4p-1},
+  {0x1.45a50c670938fp-1, 0x1.4e41b240cd91fp-1}, {0x1.44d67190f8b43p-1, 0x1.5016eb701e618p-1},
+  {0x1.4408dc3e05b22p-1, 0x1.51eafb4af6513p-1}, {0x1.433c4a7ee52b4p-1, 0x1.53bde34937c7fp-1},
+  {0x1.4270ba692bc4dp-1, 0x1.558fa4dffe247p-1}, {0x1.41a62a173e821p-1, 0x1.57604181a4b98p-1},
+  {0x1.40dc97a843ae8p-1, 0x1.592fba9dcdb54p-1}, {0x1.4014014014014p-1, 0x1.5afe11a168f21p-1},
+  {0x1.3f4c65072bf74p-1, 0x1.5ccb47f6bab3dp-1}, {0x1.3e85c12a9d651p-1, 0x1.5e975f05624dep-1},
+  {0x1.3dc013dc013dcp-1, 0x1.6062583260b63p-1}, {0x1.3cfb5b51698ebp-1, 0x1.622c34e01f039p-1},
+  {0x1.3c3795c553afbp-1, 0x1.63f4f66e74d71p-1}, {0x1.3b74c1769aa5cp-1, 0x1.65bc9e3aaeb2cp-1},
+  {0x1.3ab2dca869b81p-1, 0x1.67832d9f943cbp-1}, {0x1.39f1e5a22f36ep-1, 0x1.6948a5f56e6d8p-1},
+  {0x1.3931daaf8f721p-1, 0x1.6b0d08920dae6p-1}, {0x1.3872ba2057e04p-1, 0x1.6cd056c8cfe1bp-1},
+  {0x1.37b4824872744p-1, 0x1.6e9291eaa65b6p-1}, {0x1.36f7317fd9212p-1, 0x1.7053bb461bc5cp-1},
+  {0x1.363ac622898b1p-1, 0x1.7213d42759f5dp-1}, {0x1.357f3e9078e5bp-1, 0x1.73d2ddd82fac3p-1},
+  {0x1.34c4992d87fd9p-1, 0x1.7590d9a016462p-1}, {0x1.340ad461776d3p-1, 0x1.774dc8c4375ccp-1},
+  {0x1.3351ee97dbfc6p-1, 0x1.7909ac877253bp-1}, {0x1.3299e6401329ap-1, 0x1.7ac4862a61d6ap-1},
+  {0x1.31e2b9cd37dc2p-1, 0x1.7c7e56eb6146fp-1}, {0x1.312c67b6173eep-1, 0x1.7e37200692187p-1},
+  {0x1.3076ee7525c2cp-1, 0x1.7feee2b5e11f4p-1}, {0x1.2fc24c8874486p-1, 0x1.81a5a0310bcccp-1},
+  {0x1.2f0e8071a5703p-1, 0x1.835b59ada55ddp-1}, {0x1.2e5b88b5e3104p-1, 0x1.8510105f1bf96p-1},
+  {0x1.2da963ddd3cfbp-1, 0x1.86c3c576bdbfep-1}, {0x1.2cf8107590e67p-1, 0x1.88767a23bdcbfp-1},
+  {0x1.2c478d0c9c013p-1, 0x1.8a282f9339248p-1}, {0x1.2b97d835d548ep-1, 0x1.8bd8e6f03ba03p-1},
+  {0x1.2ae8f087718d0p-1, 0x1.8d88a163c4ba8p-1}, {0x1.2a3ad49af0907p-1, 0x1.8f376014cc5adp-1},
+  {0x1.298d830d13780p-1, 0x1.90e52428478dap-1}, {0x1.28e0fa7dd35a3p-1, 0x1.9291eec12d303p-1},
+  {0x1.2835399057efdp-1, 0x1.943dc1007a8ebp-1}, {0x1.278a3eeaee650p-1, 0x1.95e89c0537f43p-1},
+  {0x1.26e009370049cp-1, 0x1.979280ec7d2e6p-1}, {0x1.263697210aa18p-1, 0x1.993b70d17604ap-1},
+  {0x1.258de75895121p-1, 0x1.9ae36ccd66a10p-1}, {0x1.24e5f89029305p-1, 0x1.9c8a75f7afed7p-1},
+  {0x1.243ec97d49eaep-1, 0x1.9e308d65d3e43p-1}, {0x1.239858d86b11fp-1, 0x1.9fd5b42b79d4dp-1},
+  {0x1.22f2a55ce8fc5p-1, 0x1.a179eb5a729b6p-1}, {0x1.224dadc900489p-1, 0x1.a31d3402bccd5p-1},
+  {0x1.21a970ddc5ba7p-1, 0x1.a4bf8f3288d92p-1}, {0x1.2105ed5f1e336p-1, 0x1.a660fdf63d1bfp-1},
+  {0x1.20632213b6c6dp-1, 0x1.a801815879e9bp-1}, {0x1.1fc10dc4fce8bp-1, 0x1.a9a11a621d8bbp-1},
+  {0x1.1f1faf3f16b64p-1, 0x1.ab3fca1a48332p-1}, {0x1.1e7f0550db594p-1, 0x1.acdd91865fe03p-1},
+  {0x1.1ddf0ecbcb841p-1, 0x1.ae7a71aa143f4p-1}, {0x1.1d3fca840a074p-1, 0x1.b0166b87627aap-1},
+  {0x1.1ca13750547fep-1, 0x1.b1b1801e99018p-1}, {0x1.1c035409fc1dfp-1, 0x1.b34bb06e5b453p-1},
+  {0x1.1b661f8cde833p-1, 0x1.b4e4fd73a56b0p-1}, {0x1.1ac998b75eb90p-1, 0x1.b67d6829cff52p-1},
+  {0x1.1a2dbe6a5e3e4p-1, 0x1.b814f18a935fep-1}, {0x1.19928f89362b7p-1, 0x1.b9ab9a8e0bb6ap-1},
+  {0x1.18f80af9b06dcp-1, 0x1.bb41642abc1dbp-1}, {0x1.185e2fa401186p-1, 0x1.bcd64f5592530p-1},
+  {0x1.17c4fc72bfcb9p-1, 0x1.be6a5d01ea252p-1}, {0x1.172c7052e1316p-1, 0x1.bffd8e2190e11p-1},
+  {0x1.16948a33b08fap-1, 0x1.c18fe3a4c8b65p-1}, {0x1.15fd4906c96f1p-1, 0x1.c3215e7a4c114p-1},
+  {0x1.1566abc011567p-1, 0x1.c4b1ff8f50eebp-1}, {0x1.14d0b155b19aep-1, 0x1.c641c7cf8c233p-1},
+  {0x1.143b58c01143bp-1, 0x1.c7d0b825349b9p-1}, {0x1.13a6a0f9cf01ep-1, 0x1.c95ed1790694fp-1},
+  {0x1.131288ffbb3b6p-1, 0x1.caec14b246ca6p-1}, {0x1.127f0fd0d2295p-1, 0x1.cc7882b6c59bcp-1},
+  {0x1.11ec346e36092p-1, 0x1.ce041c6ae22b1p-1}, {0x1.1159f5db29606p-1, 0x1.cf8ee2b18d71ep-1},
+  {0x1.10c8531d0952ep-1, 0x1.d118d66c4d4e4p-1}, {0x1.10374b3b480aap-1, 0x1.d2a1f87b3f886p-1},
+  {0x1.0fa6dd3f67322p-1, 0x1.d42a49bd1ccecp-1}, {0x1.0f170834f27fap-1, 0x1.d5b1cb0f3babdp-1},
+  {0x1.0e87cb297a51ep-1, 0x1.d7387d4d93737p-1}, {0x1.0df9252c8e5e6p-1, 0x1.d8be6152bf277p-1},
+  {0x1.0d6b154fb86f9p-1, 0x1.da4377f800569p-1}, {0x1.0cdd9aa677344p-1, 0x1.dbc7c21541f28p-1},
+  {0x1.0c50b446391f3p-1, 0x1.dd4b40811b1e6p-1}, {0x1.0bc4614657569p-1, 0x1.decdf410d1f70p-1},
+  {0x1.0b38a0c010b39p-1, 0x1.e04fdd985e52cp-1}, {0x1.0aad71ce84d16p-1, 0x1.e1d0fdea6c7b1p-1},
+  {0x1.0a22d38eaf2bfp-1, 0x1.e35155d85fddbp-1}, {0x1.0998c51f624d5p-1, 0x1.e4d0e63255b91p-1},
+  {0x1.090f45a1430aap-1, 0x1.e64fafc727bf6p-1}, {0x1.08865436c3cf7p-1, 0x1.e7cdb3646eb43p-1},
+  {0x1.07fdf0041ff7cp-1, 0x1.e94af1d685033p-1}, {0x1.0776182f57386p-1, 0x1.eac76be8894fdp-1},
+  {0x1.06eecbe029155p-1, 0x1.ec43226460ff1p-1}, {0x1.06680a4010668p-1, 0x1.edbe1612bab98p-1},
+  {0x1.05e1d27a3ee9cp-1, 0x1.ef3847bb10e87p-1}, {0x1.055c23bb98e2ap-1, 0x1.f0b1b823ac2b9p-1},
+  {0x1.04d6fd32b0c7bp-1, 0x1.f22a6811a5c8bp-1}, {0x1.04525e0fc2fcbp-1, 0x1.f3a25848ea157p-1},
+  {0x1.03ce4584b19a0p-1, 0x1.f519898c3adabp-1}, {0x1.034ab2c50040dp-1, 0x1.f68ffc9d31b1fp-1},
+  {0x1.02c7a505cffbfp-1, 0x1.f805b23c425c8p-1}, {0x1.02451b7ddb2d2p-1, 0x1.f97aab28bd154p-1},
+  {0x1.01c315657186bp-1, 0x1.faeee820d0dc0p-1}, {0x1.014191f674111p-1, 0x1.fc6269e18dbc0p-1},
+  {0x1.00c0906c513cfp-1, 0x1.fdd53126e70aep-1}, {0x1.0040100401004p-1, 0x1.ff473eabb5a4bp-1},
+};
+
+const double fast_exp2_table[256] = {
+  0x1.0000000000000p+0, 0x1.00b1afa5abcbfp+0, 0x1.0163da9fb3335p+0, 0x1.02168143b0281p+0,
+  0x1.02c9a3e778061p+0, 0x1.037d42e11bbccp+0, 0x1.04315e86e7f85p+0, 0x1.04e5f72f654b1p+0,
+  0x1.059b0d3158574p+0, 0x1.0650a0e3c1f89p+0, 0x1.0706b29ddf6dep+0, 0x1.07bd42b72a836p+0,
+  0x1.0874518759bc8p+0, 0x1.092bdf66607e0p+0, 0x1.09e3ecac6f383p+0, 0x1.0a9c79b1f3919p+0,
+  0x1.0b5586cf9890fp+0, 0x1.0c0f145e46c85p+0, 0x1.0cc922b7247f7p+0, 0x1.0d83b23395decp+0,
+  0x1.0e3ec32d3d1a2p+0, 0x1.0efa55fdfa9c5p+0, 0x1.0fb66affed31bp+0, 0x1.1073028d7233ep+0,
+  0x1.11301d0125b51p+0, 0x1.11edbab5e2ab6p+0, 0x1.12abdc06c31ccp+0, 0x1.136a814f204abp+0,
+  0x1.1429aaea92de0p+0, 0x1.14e95934f312ep+0, 0x1.15a98c8a58e51p+0, 0x1.166a45471c3c2p+0,
+  0x1.172b83c7d517bp+0, 0x1.17ed48695bbc0p+0, 0x1.18af9388c8deap+0, 0x1.1972658375d2fp+0,
+  0x1.1a35beb6fcb75p+0, 0x1.1af99f8138a1cp+0, 0x1.1bbe084045cd4p+0, 0x1.1c82f95281c6bp+0,
+  0x1.1d4873168b9aap+0, 0x1.1e0e75eb44027p+0, 0x1.1ed5022fcd91dp+0, 0x1.1f9c18438ce4dp+0,
+  0x1.2063b88628cd6p+0, 0x1.212be3578a819p+0, 0x1.21f49917ddc96p+0, 0x1.22bdda27912d1p+0,
+  0x1.2387a6e756238p+0, 0x1.2451ffb82140ap+0, 0x1.251ce4fb2a63fp+0, 0x1.25e85711ece75p+0,
+  0x1.26b4565e27cddp+0, 0x1.2780e341ddf29p+0, 0x1.284dfe1f56381p+0, 0x1.291ba7591bb70p+0,
+  0x1.29e9df51fdee1p+0, 0x1.2ab8a66d10f13p+0, 0x1.2b87fd0dad990p+0, 0x1.2c57e39771b2fp+0,
+  0x1.2d285a6e4030bp+0, 0x1.2df961f641589p+0, 0x1.2ecafa93e2f56p+0, 0x1.2f9d24abd886bp+0,
+  0x1.306fe0a31b715p+0, 0x1.31432edeeb2fdp+0, 0x1.32170fc4cd831p+0, 0x1.32eb83ba8ea32p+0,
+  0x1.33c08b26416ffp+0, 0x1.3496266e3fa2dp+0, 0x1.356c55f929ff1p+0, 0x1.36431a2de883bp+0,
+  0x1.371a7373aa9cbp+0, 0x1.37f26231e754ap+0, 0x1.38cae6d05d866p+0, 0x1.39a401b7140efp+0,
+  0x1.3a7db34e59ff7p+0, 0x1.3b57fbfec6cf4p+0, 0x1.3c32dc313a8e5p+0, 0x1.3d0e544ede173p+0,
+  0x1.3dea64c123422p+0, 0x1.3ec70df1c5175p+0, 0x1.3fa4504ac801cp+0, 0x1.40822c367a024p+0,
+  0x1.4160a21f72e2ap+0, 0x1.423fb2709468ap+0, 0x1.431f5d950a897p+0, 0x1.43ffa3f84b9d4p+0,
+  0x1.44e086061892dp+0, 0x1.45c2042a7d232p+0, 0x1.46a41ed1d0057p+0, 0x1.4786d668b3237p+0,
+  0x1.486a2b5c13cd0p+0, 0x1.494e1e192aed2p+0, 0x1.4a32af0d7d3dep+0, 0x1.4b17dea6db7d7p+0,
+  0x1.4bfdad5362a27p+0, 0x1.4ce41b817c114p+0, 0x1.4dcb299fddd0dp+0, 0x1.4eb2d81d8abffp+0,
+  0x1.4f9b2769d2ca7p+0, 0x1.508417f4531eep+0, 0x1.516daa2cf6642p+0, 0x1.5257de83f4eefp+0,
+  0x1.5342b569d4f82p+0, 0x1.542e2f4f6ad27p+0, 0x1.551a4ca5d920fp+0, 0x1.56070dde910d2p+0,
+  0x1.56f4736b527dap+0, 0x1.57e27dbe2c4cfp+0, 0x1.58d12d497c7fdp+0, 0x1.59c0827ff07ccp+0,
+  0x1.5ab07dd485429p+0, 0x1.5ba11fba87a03p+0, 0x1.5c9268a5946b7p+0, 0x1.5d84590998b93p+0,
+  0x1.5e76f15ad2148p+0, 0x1.5f6a320dceb71p+0, 0x1.605e1b976dc09p+0, 0x1.6152ae6cdf6f4p+0,
+  0x1.6247eb03a5585p+0, 0x1.633dd1d1929fdp+0, 0x1.6434634ccc320p+0, 0x1.652b9febc8fb7p+0,
+  0x1.6623882552225p+0, 0x1.671c1c70833f6p+0, 0x1.68155d44ca973p+0, 0x1.690f4b19e9538p+0,
+  0x1.6a09e667f3bcdp+0, 0x1.6b052fa75173ep+0, 0x1.6c012750bdabfp+0, 0x1.6cfdcddd47645p+0,
+  0x1.6dfb23c651a2fp+0, 0x1.6ef9298593ae5p+0, 0x1.6ff7df9519484p+0, 0x1.70f7466f42e87p+0,
+  0x1.71f75e8ec5f74p+0, 0x1.72f8286ead08ap+0, 0x1.73f9a48a58174p+0, 0x1.74fbd35d7cbfdp+0,
+  0x1.75feb564267c9p+0, 0x1.77024b1ab6e09p+0, 0x1.780694fde5d3fp+0, 0x1.790b938ac1cf6p+0,
+  0x1.7a11473eb0187p+0, 0x1.7b17b0976cfdbp+0, 0x1.7c1ed0130c132p+0, 0x1.7d26a62ff86f0p+0,
+  0x1.7e2f336cf4e62p+0, 0x1.7f3878491c491p+0, 0x1.80427543e1a12p+0, 0x1.814d2add106d9p+0,
+  0x1.82589994cce13p+0, 0x1.8364c1eb941f7p+0, 0x1.8471a4623c7adp+0, 0x1.857f4179f5b21p+0,
+  0x1.868d99b4492edp+0, 0x1.879cad931a436p+0, 0x1.88ac7d98a6699p+0, 0x1.89bd0a478580fp+0,
+  0x1.8ace5422aa0dbp+0, 0x1.8be05bad61778p+0, 0x1.8cf3216b5448cp+0, 0x1.8e06a5e0866d9p+0,
+  0x1.8f1ae99157736p+0, 0x1.902fed0282c8ap+0, 0x1.9145b0b91ffc6p+0, 0x1.925c353aa2fe2p+0,
+  0x1.93737b0cdc5e5p+0, 0x1.948b82b5f98e5p+0, 0x1.95a44cbc8520fp+0, 0x1.96bdd9a7670b3p+0,
+  0x1.97d829fde4e50p+0, 0x1.98f33e47a22a2p+0, 0x1.9a0f170ca07bap+0, 0x1.9b2bb4d53fe0dp+0,
+  0x1.9c49182a3f090p+0, 0x1.9d674194bb8d5p+0, 0x1.9e86319e32323p+0, 0x1.9fa5e8d07f29ep+0,
+  0x1.a0c667b5de565p+0, 0x1.a1e7aed8eb8bbp+0, 0x1.a309bec4a2d33p+0, 0x1.a42c980460ad8p+0,
+  0x1.a5503b23e255dp+0, 0x1.a674a8af46052p+0, 0x1.a799e1330b358p+0, 0x1.a8bfe53c12e59p+0,
+  0x1.a9e6b5579fdbfp+0, 0x1.ab0e521356ebap+0, 0x1.ac36bbfd3f37ap+0, 0x1.ad5ff3a3c2774p+0,
+  0x1.ae89f995ad3adp+0, 0x1.afb4ce622f2ffp+0, 0x1.b0e07298db666p+0, 0x1.b20ce6c9a8952p+0,
+  0x1.b33a2b84f15fbp+0, 0x1.b468415b749b1p+0, 0x1.b59728de5593ap+0, 0x1.b6c6e29f1c52ap+0,
+  0x1.b7f76f2fb5e47p+0, 0x1.b928cf22749e4p+0, 0x1.ba5b030a1064ap+0, 0x1.bb8e0b79a6f1fp+0,
+  0x1.bcc1e904bc1d2p+0, 0x1.bdf69c3f3a207p+0, 0x1.bf2c25bd71e09p+0, 0x1.c06286141b33dp+0,
+  0x1.c199bdd85529cp+0, 0x1.c2d1cd9fa652cp+0, 0x1.c40ab5fffd07ap+0, 0x1.c544778fafb22p+0,
+  0x1.c67f12e57d14bp+0, 0x1.c7ba88988c933p+0, 0x1.c8f6d9406e7b5p+0, 0x1.ca3405751c4dbp+0,
+  0x1.cb720dcef9069p+0, 0x1.ccb0f2e6d1675p+0, 0x1.cdf0b555dc3fap+0, 0x1.cf3155b5bab74p+0,
+  0x1.d072d4a07897cp+0, 0x1.d1b532b08c968p+0, 0x1.d2f87080d89f2p+0, 0x1.d43c8eacaa1d6p+0,
+  0x1.d5818dcfba487p+0, 0x1.d6c76e862e6d3p+0, 0x1.d80e316c98398p+0, 0x1.d955d71ff6075p+0,
+  0x1.da9e603db3285p+0, 0x1.dbe7cd63a8315p+0, 0x1.dd321f301b460p+0, 0x1.de7d5641c0658p+0,
+  0x1.dfc97337b9b5fp+0, 0x1.e11676b197d17p+0, 0x1.e264614f5a129p+0, 0x1.e3b333b16ee12p+0,
+  0x1.e502ee78b3ff6p+0, 0x1.e653924676d76p+0, 0x1.e7a51fbc74c83p+0, 0x1.e8f7977cdb740p+0,
+  0x1.ea4afa2a490dap+0, 0x1.eb9f4867cca6ep+0, 0x1.ecf482d8e67f1p+0, 0x1.ee4aaa2188510p+0,
+  0x1.efa1bee615a27p+0, 0x1.f0f9c1cb6412ap+0, 0x1.f252b376bba97p+0, 0x1.f3ac948dd7274p+0,
+  0x1.f50765b6e4540p+0, 0x1.f6632798844f8p+0, 0x1.f7bfdad9cbe14p+0, 0x1.f91d802243c89p+0,
+  0x1.fa7c1819e90d8p+0, 0x1.fbdba3692d514p+0, 0x1.fd3c22b8f71f1p+0, 0x1.fe9d96b2a23d9p+0,
+};
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "drag.h"
+#include "options.h"
 
 #include <math.h>
 
@@ -67,6 +68,28 @@ static inline double rad_to_moa(double rad) {
 double zero_angle(DragFunction drag_function, double drag_coefficient, double vi, double sight_height, double zero_range,
                   double y_intercept);
 
+/**
+ * The outcome of a zero_angle_ex() search.
+ */
+typedef struct {
+  double angle;     // The angle of the bore relative to the sighting system, in degrees.
+  double tolerance; // The size of the final angle correction, in MOA; the achieved accuracy.
+  int iterations;   // The number of trajectories integrated.
+} ZeroResult;
+
+/**
+ * zero_angle() with a choice of search method.  The parameters shared with zero_angle() have the same meaning,
+ * with y_intercept in inches as documented under either method.  Both methods integrate with Ballistics_solve()'s
+ * half-foot step, so they converge on the same trajectory.  zero_angle() itself keeps its historical behavior:
+ * it compares y_intercept against the path in feet and integrates with a one foot step.
+ * @param options Optional choices: zero_method, zero_tolerance, drag_mode, drag_table, atmosphere and math are
+ *                honored.  NULL selects the bisection at 0.01 MOA.
+ * @param result  Receives the angle, the achieved tolerance and the iteration count.
+ * @return 0 on success, or -1 if the zero range cannot be reached below a 45 degree bore angle.
+ */
+int zero_angle_ex(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                  double zero_range, double y_intercept, const BallisticsOptions* options, ZeroResult* result);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
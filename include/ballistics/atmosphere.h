@@ -35,6 +35,48 @@ extern "C" {
 double atmosphere_correction(double drag_coefficient, double altitude, double barometer, double temperature,
                              double relative_humidity);
 
+/**
+ * Air that varies with height along the trajectory: the ICAO standard atmosphere, offset to match the conditions
+ * measured at the firing point.  Temperature falls at the standard lapse rate up to the tropopause and pressure
+ * follows hydrostatically, with the measured humidity throughout.  Density and speed of sound are tabulated once,
+ * every 20 feet from 5,000 feet below the firing point to 45,000 feet above it, so the integrators look them up
+ * per step at the cost of an index and a blend.
+ *
+ * Select a profile for a solve with BallisticsOptions.atmosphere.  It replaces atmosphere_correction(): give the
+ * solver the standard drag coefficient.  Profiles are immutable once built and can be shared between threads.
+ */
+typedef struct AtmosphereProfile AtmosphereProfile;
+
+/**
+ * @param altitude          The firing point's altitude above sea level in feet.
+ * @param barometer         The barometric pressure in inches of mercury, standardized to sea level as reported,
+ *                          the same as for atmosphere_correction().  ICAO standard pressure is 29.92 in Hg.
+ * @param temperature       The temperature at the firing point in Fahrenheit.
+ * @param relative_humidity The relative humidity fraction, from 0.00 to 1.00.
+ * @return The profile, or NULL if memory is not available.
+ */
+AtmosphereProfile* AtmosphereProfile_create(double altitude, double barometer, double temperature,
+                                            double relative_humidity);
+
+/**
+ * The ICAO standard atmosphere, dry, for a firing point at altitude feet.
+ */
+AtmosphereProfile* AtmosphereProfile_create_standard(double altitude);
+
+void AtmosphereProfile_free(AtmosphereProfile* profile);
+
+/**
+ * @param height Feet above the firing point.
+ * @return The air density relative to the ICAO sea level standard.
+ */
+double AtmosphereProfile_density_ratio(const AtmosphereProfile* profile, double height);
+
+/**
+ * @param height Feet above the firing point.
+ * @return The speed of sound, in ft/s.
+ */
+double AtmosphereProfile_speed_of_sound(const AtmosphereProfile* profile, double height);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -16,20 +16,33 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #include "constants.h"
+#include "options.h"
 #include "angle.h"
 #include "atmosphere.h"
 #include "windage.h"
 #include "pbr.h"
+#include "cache.h"
+#include "montecarlo.h"
+#include "trajectory.h"
+#include "event.h"
+#include "truing.h"
 
 typedef struct Ballistics Ballistics;
 
 // Functions for retrieving data from a solution generated with solve()
+
+// Releases a reference to the solution; the last release frees it.
 void Ballistics_free(Ballistics* ballistics);
+// Takes another reference to the solution, e.g. to share it between threads.  Each reference is released
+// with Ballistics_free().
+Ballistics* Ballistics_retain(Ballistics* ballistics);
 
 // Returns range, in yards.
 double Ballistics_get_range(Ballistics* ballistics, int yardage);
@@ -51,6 +64,95 @@ double Ballistics_get_vx_fps(Ballistics* ballistics, int yardage);
 // Returns the velocity of the projectile perpendicular to the bore direction.
 double Ballistics_get_vy_fps(Ballistics* ballistics, int yardage);
 
+// Returns the number of rows in the solution, i.e. one past its furthest valid yardage.
+int Ballistics_get_max_yardage(Ballistics* ballistics);
+
+/**
+ * The quantities a solution holds for every row.  Each is stored as its own contiguous column.
+ */
+typedef enum {
+  BALLISTICS_COL_RANGE = 0,   // Ballistics_get_range()
+  BALLISTICS_COL_PATH,        // Ballistics_get_path()
+  BALLISTICS_COL_MOA,         // Ballistics_get_moa()
+  BALLISTICS_COL_TIME,        // Ballistics_get_time()
+  BALLISTICS_COL_WINDAGE,     // Ballistics_get_windage()
+  BALLISTICS_COL_WINDAGE_MOA, // Ballistics_get_windage_moa()
+  BALLISTICS_COL_V,           // Ballistics_get_v_fps()
+  BALLISTICS_COL_VX,          // Ballistics_get_vx_fps()
+  BALLISTICS_COL_VY,          // Ballistics_get_vy_fps()
+  BALLISTICS_COLUMNS
+} BallisticsColumn;
+
+/**
+ * Copies rows [start, start+count) of one column, clipped to the rows solved.
+ * @param column The quantity to copy.
+ * @param start  The first row (yardage) to copy.
+ * @param count  The number of rows to copy.
+ * @param stride The distance, in doubles, between consecutive values written to out.  1 packs them.
+ * @param out    Receives the values at out[0], out[stride], ...
+ * @return The number of rows copied; 0 if column is not a column, start or count is negative, or stride is
+ *         less than 1.
+ */
+int Ballistics_copy_column(Ballistics* ballistics, BallisticsColumn column, int start, int count, int stride,
+                           double* out);
+
+/**
+ * A zero-copy view of one column: Ballistics_get_max_yardage() values, indexed by row, 64-byte aligned.
+ * The view is valid until the solution is solved into again or freed.
+ * @return The column, or NULL if column is not a BallisticsColumn.
+ */
+const double* Ballistics_column_ptr(Ballistics* ballistics, BallisticsColumn column);
+
+/**
+ * A place in a solution's time index, kept per projectile between Ballistics_state_at_time() calls.
+ * Zero-initialize it before the first call.
+ */
+typedef struct {
+  int row;
+} BallisticsTimeCursor;
+
+/**
+ * The solution at a time of flight, e.g. at each frame of a simulation, interpolated linearly between the rows
+ * on either side; angles are taken from the interpolated position.  Rows are in increasing time, so with a
+ * cursor, a time a little after the previous one is found in constant time; earlier times are binary searched.
+ * Safe to call from several threads on the same solution, each with its own cursor, unless a
+ * Ballistics_update_crosswind_lazy() is pending.
+ * @param seconds The time, from the first row's time to the last's.
+ * @param cursor  Where the previous call left off, updated; or NULL to search from the start.
+ * @param row     Receives BALLISTICS_COLUMNS values, indexed by BallisticsColumn.
+ * @return 0, or -1 if seconds is outside the solution.
+ */
+int Ballistics_state_at_time(Ballistics* ballistics, double seconds, BallisticsTimeCursor* cursor, double* row);
+
+/**
+ * Ballistics_state_at_time() for n times, fastest in increasing order, into n rows of BALLISTICS_COLUMNS values
+ * back to back.  Rows for times outside the solution are NaN.
+ * @return The number of times inside the solution.
+ */
+size_t Ballistics_states_at_times(Ballistics* ballistics, const double* seconds, size_t n, double* rows);
+
+/**
+ * Recomputes the windage columns for a new wind from the stored ranges and times, without integrating again;
+ * e.g. as a wind slider moves.  Only the crosswind component is applied: path, velocity and time keep the
+ * headwind of the original solve, which moves them far less than crosswind moves windage.  Windage agrees with
+ * a full solve in the new wind to rounding, and replaces the drift of any BallisticsOptions.wind profile with
+ * a uniform crosswind.  Solutions shared by a BallisticsCache are read-only and must not be updated.
+ * @param wind_speed The wind velocity, in mi/hr.
+ * @param wind_angle The wind direction, in degrees, as for Ballistics_solve().
+ */
+void Ballistics_update_crosswind(Ballistics* ballistics, double wind_speed, double wind_angle);
+
+/**
+ * Ballistics_update_crosswind() deferred until windage is read.  Ballistics_get_windage() and
+ * Ballistics_get_windage_moa() then compute only the rows asked for, and the first Ballistics_column_ptr() or
+ * Ballistics_copy_column() of a windage column fills in both columns.  Until then, do not read the handle from
+ * several threads at once.
+ */
+void Ballistics_update_crosswind_lazy(Ballistics* ballistics, double wind_speed, double wind_angle);
+
+// Returns the number of retardation evaluations the integrator needed to produce the solution.
+long Ballistics_get_drag_evaluations(Ballistics* ballistics);
+
 // For very steep shooting angles, vx can actually become what you would think of as vy relative to the ground,
 // because vx is referencing the bore's axis.  All computations are carried out relative to the bore's axis, and
 // have very little to do with the ground's orientation.
@@ -83,6 +185,86 @@ double Ballistics_get_vy_fps(Ballistics* ballistics, int yardage);
 int Ballistics_solve(Ballistics** ballistics, DragFunction drag_function, double drag_coefficient, double vi,
                      double sight_height, double shooting_angle, double zero_angle, double wind_speed, double wind_angle);
 
+/**
+ * Ballistics_solve() with per-call options.
+ * @param ballistics A pointer provided for accessing the solution after it has been generated.
+ * @param in         The projectile, sight and wind, as for Ballistics_solve().
+ * @param options    Optional choices for how the solution is computed.  NULL selects the standard behavior,
+ *                   which is identical to Ballistics_solve().
+ * @return The maximum valid range of the solution, as for Ballistics_solve().
+ */
+int Ballistics_solve_ex(Ballistics** ballistics, const BallisticsInput* in, const BallisticsOptions* options);
+
+/**
+ * Creates an empty solution handle with room for yards 0 through max_yards.  The handle can be solved into
+ * any number of times with Ballistics_solve_into(); free it with Ballistics_free().
+ * @param max_yards The furthest yard the handle is expected to hold.  Solving further grows it.
+ * @return The handle, or NULL if memory is not available.
+ */
+Ballistics* Ballistics_create(size_t max_yards);
+
+/**
+ * Discards the solution held by a handle, keeping its memory for the next Ballistics_solve_into().
+ */
+void Ballistics_reset(Ballistics* ballistics);
+
+/**
+ * Solves into a caller-owned handle, integrating only as far as max_yards.  When the handle already has room
+ * for max_yards, no memory is allocated, so one handle can be reused across many solves.
+ * @param ballistics A handle from Ballistics_create() or a previous solve.  Its previous solution is replaced.
+ * @param max_yards  The furthest yard to solve.  Integration stops once it is recorded, or earlier if the
+ *                   trajectory terminates first.  Capped at BALLISTICS_COMPUTATION_MAX_YARDS rows.
+ * @param in         The projectile, sight and wind, as for Ballistics_solve().
+ * @param options    Optional choices for how the solution is computed; NULL selects the standard behavior.
+ * @return The number of rows solved (max_yards + 1 unless the trajectory terminated first), or -1 if the
+ *         handle could not be grown.
+ */
+int Ballistics_solve_into(Ballistics* ballistics, size_t max_yards, const BallisticsInput* in,
+                          const BallisticsOptions* options);
+
+/**
+ * Solves only at a list of ranges, such as the distances to a handful of targets.  Each sample is interpolated
+ * within the integration step that brackets it, and integration stops after the last one.
+ * Row i of the solution holds the sample at ranges[i]; pass i as the yardage to the Ballistics_get_*()
+ * functions, and Ballistics_get_range() returns ranges[i].
+ * @param ballistics A handle from Ballistics_create() or a previous solve.  Its previous solution is replaced.
+ * @param ranges     The ranges to sample, in yards, in ascending order.
+ * @param n          The number of ranges.
+ * @param in         The projectile, sight and wind, as for Ballistics_solve().
+ * @param options    Optional choices for how the solution is computed; NULL selects the standard behavior.
+ * @return The number of rows solved (n unless the trajectory terminated first), or -1 if the ranges are not
+ *         ascending and non-negative or the handle could not be grown.
+ */
+int Ballistics_solve_ranges(Ballistics* ballistics, const double* ranges, size_t n, const BallisticsInput* in,
+                            const BallisticsOptions* options);
+
+/**
+ * Ballistics_solve_ranges() at start_yards, start_yards + step_yards, ... up to and including end_yards;
+ * e.g. a 25, 50 or 100 yard dope card.
+ * @return The number of rows solved, or -1 if the steps are not well formed or the handle could not be grown.
+ */
+int Ballistics_solve_steps(Ballistics* ballistics, double start_yards, double step_yards, double end_yards,
+                           const BallisticsInput* in, const BallisticsOptions* options);
+
+/**
+ * Solves many trajectories at once.  Trajectories are integrated together in lanes over structure-of-arrays
+ * state; a lane is retired as soon as its trajectory terminates and is refilled with the next input.
+ * Every solution is identical, row for row, to the one Ballistics_solve() produces for the same input, and
+ * holds only the rows its trajectory needs.
+ * @param in            The n inputs to solve.
+ * @param n             The number of inputs.
+ * @param ballistics    An array of n pointers which receive the solutions.  Free each with Ballistics_free().
+ *                      On failure every pointer is NULL.
+ * @param max_yardages  Optional array of n ints which receive each solution's maximum valid range,
+ *                      i.e. what Ballistics_solve() would have returned.  May be NULL.
+ * @param threads       The number of worker threads to spread the batch over.  0 or 1 solves on the calling thread.
+ *                      The calling thread always works too, so workers that cannot be started only cost
+ *                      parallelism.
+ * @return 0, or -1 if n is not 0 and in or ballistics is NULL, or if memory for the solutions is not available.
+ */
+int Ballistics_solve_batch(const BallisticsInput* in, size_t n, Ballistics** ballistics, int* max_yardages,
+                           int threads);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
\ No newline at end of file
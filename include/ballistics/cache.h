@@ -0,0 +1,88 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "options.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Inputs are quantized to these steps before lookup, so that nearly identical requests share an entry.
+// Results are computed from the quantized inputs, so they do not depend on which request came first.
+#define BALLISTICS_CACHE_BC_STEP       1e-4 // drag coefficient
+#define BALLISTICS_CACHE_VELOCITY_STEP 0.1  // ft/s
+#define BALLISTICS_CACHE_INCHES_STEP   0.01 // sight height and y-intercept, in inches
+#define BALLISTICS_CACHE_YARDS_STEP    0.1  // zero range, in yards
+#define BALLISTICS_CACHE_ANGLE_STEP    1e-6 // shooting, zero and wind angles, in degrees
+#define BALLISTICS_CACHE_WIND_STEP     0.01 // wind speed, in mi/hr
+
+/**
+ * A bounded, thread-safe memo of zero angles and solutions.  Entries are spread over lock stripes, each with
+ * its own least-recently-used eviction, so many threads can look up concurrently.  Options are part of the key;
+ * a BallisticsOptions.drag_table, atmosphere or wind is matched by address, so keep it alive as long as the cache.
+ */
+typedef struct BallisticsCache BallisticsCache;
+
+typedef struct {
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+} BallisticsCacheStats;
+
+/**
+ * @param capacity The maximum number of entries, zero angles and solutions together.  Entries are spread by hash
+ *                 over 16 independently locked stripes, each holding its share of capacity, so a stripe can
+ *                 evict before the cache as a whole holds capacity entries.
+ * @return The cache, or NULL if memory is not available.
+ */
+BallisticsCache* BallisticsCache_create(size_t capacity);
+
+/**
+ * Frees the cache.  Solutions it handed out stay valid until their holders free them.
+ */
+void BallisticsCache_free(BallisticsCache* cache);
+
+/**
+ * zero_angle_ex(), memoized.  The parameters have the same meaning as for zero_angle_ex(), except that
+ * options->stats is not filled in.  Failed searches are not cached.
+ * @return The angle of the bore relative to the sighting system, in degrees, or NaN if zero_angle_ex() fails
+ *         or memory is not available.
+ */
+double BallisticsCache_zero_angle(BallisticsCache* cache, DragFunction drag_function, double drag_coefficient,
+                                  double vi, double sight_height, double zero_range, double y_intercept,
+                                  const BallisticsOptions* options);
+
+/**
+ * Ballistics_solve_into(), memoized.  The solution is shared, not copied: treat it as read-only, never solve
+ * into it, and release it with Ballistics_free() when done.  options->stats is not filled in.
+ * @param max_yards The furthest yard to solve, as for Ballistics_solve_into().
+ * @return A reference to the solution, or NULL if memory is not available.
+ */
+struct Ballistics* BallisticsCache_solve(BallisticsCache* cache, size_t max_yards, const BallisticsInput* in,
+                                         const BallisticsOptions* options);
+
+/**
+ * Reads the cache's hit, miss and eviction counters.
+ */
+void BallisticsCache_get_stats(BallisticsCache* cache, BallisticsCacheStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
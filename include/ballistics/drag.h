@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include "fastmath.h"
+
 #include <math.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,125 +29,204 @@ typedef enum {
   G1 = 1, G2, G3, G4, G5, G6, G7, G8
 } DragFunction;
 
+// The standard drag functions are piecewise power laws in the projectile velocity.  Each table below lists
+// X(threshold, acceleration, mass) segments, fastest first; a segment applies when vp > threshold, and the
+// retardation it yields is acceleration * vp^mass / drag_coefficient.
+
+#define DRAG_G1_SEGMENTS(X) \
+  X(4230, 1.477404177730177e-04, 1.9565) \
+  X(3680, 1.920339268755614e-04, 1.925) \
+  X(3450, 2.894751026819746e-04, 1.875) \
+  X(3295, 4.349905111115636e-04, 1.825) \
+  X(3130, 6.520421871892662e-04, 1.775) \
+  X(2960, 9.748073694078696e-04, 1.725) \
+  X(2830, 1.453721560187286e-03, 1.675) \
+  X(2680, 2.162887202930376e-03, 1.625) \
+  X(2460, 3.209559783129881e-03, 1.575) \
+  X(2225, 3.904368218691249e-03, 1.55) \
+  X(2015, 3.222942271262336e-03, 1.575) \
+  X(1890, 2.203329542297809e-03, 1.625) \
+  X(1810, 1.511001028891904e-03, 1.675) \
+  X(1730, 8.609957592468259e-04, 1.75) \
+  X(1595, 4.086146797305117e-04, 1.85) \
+  X(1520, 1.954473210037398e-04, 1.95) \
+  X(1420, 5.431896266462351e-05, 2.125) \
+  X(1360, 8.847742581674416e-06, 2.375) \
+  X(1315, 1.456922328720298e-06, 2.625) \
+  X(1280, 2.419485191895565e-07, 2.875) \
+  X(1220, 1.657956321067612e-08, 3.25) \
+  X(1185, 4.745469537157371e-10, 3.75) \
+  X(1150, 1.379746590025088e-11, 4.25) \
+  X(1100, 4.070157961147882e-13, 4.75) \
+  X(1060, 2.938236954847331e-14, 5.125) \
+  X(1025, 1.228597370774746e-14, 5.25) \
+  X( 980, 2.916938264100495e-14, 5.125) \
+  X( 945, 3.855099424807451e-13, 4.75) \
+  X( 905, 1.185097045689854e-11, 4.25) \
+  X( 860, 3.566129470974951e-10, 3.75) \
+  X( 810, 1.045513263966272e-08, 3.25) \
+  X( 780, 1.291159200846216e-07, 2.875) \
+  X( 750, 6.824429329105383e-07, 2.625) \
+  X( 700, 3.569169672385163e-06, 2.375) \
+  X( 640, 1.839015095899579e-05, 2.125) \
+  X( 600, 5.71117468873424e-05 , 1.950) \
+  X( 550, 9.226557091973427e-05, 1.875) \
+  X( 250, 9.337991957131389e-05, 1.875) \
+  X( 100, 7.225247327590413e-05, 1.925) \
+  X(  65, 5.792684957074546e-05, 1.975) \
+  X(   0, 5.206214107320588e-05, 2.000)
+
+#define DRAG_G2_SEGMENTS(X) \
+  X(1674, 0.0079470052136733  , 1.36999902851493) \
+  X(1172, 1.00419763721974e-03, 1.65392237010294) \
+  X(1060, 7.15571228255369e-23, 7.91913562392361) \
+  X( 949, 1.39589807205091e-10, 3.81439537623717) \
+  X( 670, 2.34364342818625e-04, 1.71869536324748) \
+  X( 335, 1.77962438921838e-04, 1.76877550388679) \
+  X(   0, 5.18033561289704e-05, 1.98160270524632)
+
+#define DRAG_G5_SEGMENTS(X) \
+  X(1730, 7.24854775171929e-03, 1.41538574492812) \
+  X(1228, 3.50563361516117e-05, 2.13077307854948) \
+  X(1116, 1.84029481181151e-13, 4.81927320350395) \
+  X(1004, 1.34713064017409e-22, 7.8100555281422) \
+  X( 837, 1.03965974081168e-07, 2.84204791809926) \
+  X( 335, 1.09301593869823e-04, 1.81096361579504) \
+  X(   0, 3.51963178524273e-05, 2.00477856801111)
+
+#define DRAG_G6_SEGMENTS(X) \
+  X(3236, 0.0455384883480781   , 1.15997674041274) \
+  X(2065, 7.167261849653769e-02, 1.10704436538885) \
+  X(1311, 1.66676386084348e-03 , 1.60085100195952) \
+  X(1144, 1.01482730119215e-07 , 2.9569674731838) \
+  X(1004, 4.31542773103552e-18 , 6.34106317069757) \
+  X( 670, 2.04835650496866e-05 , 2.11688446325998) \
+  X(   0, 7.50912466084823e-05 , 1.92031057847052)
+
+#define DRAG_G7_SEGMENTS(X) \
+  X(4200, 1.29081656775919e-09, 3.24121295355962) \
+  X(3000, 0.0171422231434847  , 1.27907168025204) \
+  X(1470, 2.33355948302505e-03, 1.52693913274526) \
+  X(1260, 7.97592111627665e-04, 1.67688974440324) \
+  X(1110, 5.71086414289273e-12, 4.3212826264889) \
+  X( 960, 3.02865108244904e-17, 5.99074203776707) \
+  X( 670, 7.52285155782535e-06, 2.1738019851075) \
+  X( 540, 1.31766281225189e-05, 2.08774690257991) \
+  X(   0, 1.34504843776525e-05, 2.08702306738884)
+
+#define DRAG_G8_SEGMENTS(X) \
+  X(3571, 0.0112263766252305  , 1.33207346655961) \
+  X(1841, 0.0167252613732636  , 1.28662041261785) \
+  X(1120, 2.20172456619625e-03, 1.55636358091189) \
+  X(1088, 2.0538037167098e-16 , 5.80410776994789) \
+  X( 976, 5.92182174254121e-12, 4.29275576134191) \
+  X(   0, 4.3917343795117e-05 , 1.99978116283334)
+
+// Selects the first segment whose threshold vp exceeds.  Expands to an if/else chain.
+#define DRAG_SELECT_SEGMENT(threshold, a, m) if (vp > threshold) { acceleration = a; mass = m; } else
+
 /**
- * A function to calculate ballistic retardation values based on standard drag functions.
+ * retard() with the power law evaluated by power, so that each math backend shares one segment table walk.
  * @param drag_function    G1, G2, G3, G4, G5, G6, G7, or G8
  * @param drag_coefficient The coefficient of drag for the projectile for the given drag function.
  * @param vp               The Velocity of the projectile.
- * @return The function returns the projectile drag retardation velocity, in ft/s per second.
+ * @param power            pow(), or a function agreeing with it, such as fast_pow().
+ * @return The projectile drag retardation velocity, in ft/s per second, or -1 wherever retard() is -1.
  */
-static inline double retard(DragFunction drag_function, double drag_coefficient, double vp) {
+static inline double retard_with(DragFunction drag_function, double drag_coefficient, double vp,
+                                 double (*power)(double, double)) {
   double acceleration = -1;
   double mass = -1;
 
   switch(drag_function) {
-    case G1:
-      if (vp > 4230) {     acceleration = 1.477404177730177e-04; mass = 1.9565; }
-      else if (vp> 3680) { acceleration = 1.920339268755614e-04; mass = 1.925 ; }
-      else if (vp> 3450) { acceleration = 2.894751026819746e-04; mass = 1.875 ; }
-      else if (vp> 3295) { acceleration = 4.349905111115636e-04; mass = 1.825 ; }
-      else if (vp> 3130) { acceleration = 6.520421871892662e-04; mass = 1.775 ; }
-      else if (vp> 2960) { acceleration = 9.748073694078696e-04; mass = 1.725 ; }
-      else if (vp> 2830) { acceleration = 1.453721560187286e-03; mass = 1.675 ; }
-      else if (vp> 2680) { acceleration = 2.162887202930376e-03; mass = 1.625 ; }
-      else if (vp> 2460) { acceleration = 3.209559783129881e-03; mass = 1.575 ; }
-      else if (vp> 2225) { acceleration = 3.904368218691249e-03; mass = 1.55  ; }
-      else if (vp> 2015) { acceleration = 3.222942271262336e-03; mass = 1.575 ; }
-      else if (vp> 1890) { acceleration = 2.203329542297809e-03; mass = 1.625 ; }
-      else if (vp> 1810) { acceleration = 1.511001028891904e-03; mass = 1.675 ; }
-      else if (vp> 1730) { acceleration = 8.609957592468259e-04; mass = 1.75  ; }
-      else if (vp> 1595) { acceleration = 4.086146797305117e-04; mass = 1.85  ; }
-      else if (vp> 1520) { acceleration = 1.954473210037398e-04; mass = 1.95  ; }
-      else if (vp> 1420) { acceleration = 5.431896266462351e-05; mass = 2.125 ; }
-      else if (vp> 1360) { acceleration = 8.847742581674416e-06; mass = 2.375 ; }
-      else if (vp> 1315) { acceleration = 1.456922328720298e-06; mass = 2.625 ; }
-      else if (vp> 1280) { acceleration = 2.419485191895565e-07; mass = 2.875 ; }
-      else if (vp> 1220) { acceleration = 1.657956321067612e-08; mass = 3.25  ; }
-      else if (vp> 1185) { acceleration = 4.745469537157371e-10; mass = 3.75  ; }
-      else if (vp> 1150) { acceleration = 1.379746590025088e-11; mass = 4.25  ; }
-      else if (vp> 1100) { acceleration = 4.070157961147882e-13; mass = 4.75  ; }
-      else if (vp> 1060) { acceleration = 2.938236954847331e-14; mass = 5.125 ; }
-      else if (vp> 1025) { acceleration = 1.228597370774746e-14; mass = 5.25  ; }
-      else if (vp>  980) { acceleration = 2.916938264100495e-14; mass = 5.125 ; }
-      else if (vp>  945) { acceleration = 3.855099424807451e-13; mass = 4.75  ; }
-      else if (vp>  905) { acceleration = 1.185097045689854e-11; mass = 4.25  ; }
-      else if (vp>  860) { acceleration = 3.566129470974951e-10; mass = 3.75  ; }
-      else if (vp>  810) { acceleration = 1.045513263966272e-08; mass = 3.25  ; }
-      else if (vp>  780) { acceleration = 1.291159200846216e-07; mass = 2.875 ; }
-      else if (vp>  750) { acceleration = 6.824429329105383e-07; mass = 2.625 ; }
-      else if (vp>  700) { acceleration = 3.569169672385163e-06; mass = 2.375 ; }
-      else if (vp>  640) { acceleration = 1.839015095899579e-05; mass = 2.125 ; }
-      else if (vp>  600) { acceleration = 5.71117468873424e-05 ; mass = 1.950 ; }
-      else if (vp>  550) { acceleration = 9.226557091973427e-05; mass = 1.875 ; }
-      else if (vp>  250) { acceleration = 9.337991957131389e-05; mass = 1.875 ; }
-      else if (vp>  100) { acceleration = 7.225247327590413e-05; mass = 1.925 ; }
-      else if (vp>   65) { acceleration = 5.792684957074546e-05; mass = 1.975 ; }
-      else if (vp>    0) { acceleration = 5.206214107320588e-05; mass = 2.000 ; }
-      break;
-
-    case G2:
-      if (vp> 1674 ) {      acceleration = 0.0079470052136733  ;  mass = 1.36999902851493; }
-      else if (vp> 1172 ) { acceleration = 1.00419763721974e-03;  mass = 1.65392237010294; }
-      else if (vp> 1060 ) { acceleration = 7.15571228255369e-23;  mass = 7.91913562392361; }
-      else if (vp>  949 ) { acceleration = 1.39589807205091e-10;  mass = 3.81439537623717; }
-      else if (vp>  670 ) { acceleration = 2.34364342818625e-04;  mass = 1.71869536324748; }
-      else if (vp>  335 ) { acceleration = 1.77962438921838e-04;  mass = 1.76877550388679; }
-      else if (vp>    0 ) { acceleration = 5.18033561289704e-05;  mass = 1.98160270524632; }
-      break;
-
-    case G5:
-      if (vp> 1730 ) {      acceleration = 7.24854775171929e-03; mass = 1.41538574492812; }
-      else if (vp> 1228 ) { acceleration = 3.50563361516117e-05; mass = 2.13077307854948; }
-      else if (vp> 1116 ) { acceleration = 1.84029481181151e-13; mass = 4.81927320350395; }
-      else if (vp> 1004 ) { acceleration = 1.34713064017409e-22; mass = 7.8100555281422 ; }
-      else if (vp>  837 ) { acceleration = 1.03965974081168e-07; mass = 2.84204791809926; }
-      else if (vp>  335 ) { acceleration = 1.09301593869823e-04; mass = 1.81096361579504; }
-      else if (vp>    0 ) { acceleration = 3.51963178524273e-05; mass = 2.00477856801111; }
-      break;
-
-    case G6:
-      if (vp> 3236 ) {      acceleration = 0.0455384883480781   ; mass = 1.15997674041274; }
-      else if (vp> 2065 ) { acceleration = 7.167261849653769e-02; mass = 1.10704436538885; }
-      else if (vp> 1311 ) { acceleration = 1.66676386084348e-03 ; mass = 1.60085100195952; }
-      else if (vp> 1144 ) { acceleration = 1.01482730119215e-07 ; mass = 2.9569674731838 ; }
-      else if (vp> 1004 ) { acceleration = 4.31542773103552e-18 ; mass = 6.34106317069757; }
-      else if (vp>  670 ) { acceleration = 2.04835650496866e-05 ; mass = 2.11688446325998; }
-      else if (vp>    0 ) { acceleration = 7.50912466084823e-05 ; mass = 1.92031057847052; }
-      break;
-
-    case G7:
-      if (vp> 4200 ) {      acceleration = 1.29081656775919e-09; mass = 3.24121295355962; }
-      else if (vp> 3000 ) { acceleration = 0.0171422231434847  ; mass = 1.27907168025204; }
-      else if (vp> 1470 ) { acceleration = 2.33355948302505e-03; mass = 1.52693913274526; }
-      else if (vp> 1260 ) { acceleration = 7.97592111627665e-04; mass = 1.67688974440324; }
-      else if (vp> 1110 ) { acceleration = 5.71086414289273e-12; mass = 4.3212826264889 ; }
-      else if (vp>  960 ) { acceleration = 3.02865108244904e-17; mass = 5.99074203776707; }
-      else if (vp>  670 ) { acceleration = 7.52285155782535e-06; mass = 2.1738019851075 ; }
-      else if (vp>  540 ) { acceleration = 1.31766281225189e-05; mass = 2.08774690257991; }
-      else if (vp>    0 ) { acceleration = 1.34504843776525e-05; mass = 2.08702306738884; }
-      break;
-
-    case G8:
-      if (vp> 3571 ) {      acceleration = 0.0112263766252305  ; mass = 1.33207346655961; }
-      else if (vp> 1841 ) { acceleration = 0.0167252613732636  ; mass = 1.28662041261785; }
-      else if (vp> 1120 ) { acceleration = 2.20172456619625e-03; mass = 1.55636358091189; }
-      else if (vp> 1088 ) { acceleration = 2.0538037167098e-16 ; mass = 5.80410776994789; }
-      else if (vp>  976 ) { acceleration = 5.92182174254121e-12; mass = 4.29275576134191; }
-      else if (vp>    0 ) { acceleration = 4.3917343795117e-05 ; mass = 1.99978116283334; }
-      break;
+    case G1: DRAG_G1_SEGMENTS(DRAG_SELECT_SEGMENT) {} break;
+    case G2: DRAG_G2_SEGMENTS(DRAG_SELECT_SEGMENT) {} break;
+    case G5: DRAG_G5_SEGMENTS(DRAG_SELECT_SEGMENT) {} break;
+    case G6: DRAG_G6_SEGMENTS(DRAG_SELECT_SEGMENT) {} break;
+    case G7: DRAG_G7_SEGMENTS(DRAG_SELECT_SEGMENT) {} break;
+    case G8: DRAG_G8_SEGMENTS(DRAG_SELECT_SEGMENT) {} break;
 
     default:
       break;
   }
 
   if (acceleration != -1 && mass != -1 && vp > 0 && vp < 10000) {
-    return acceleration * pow(vp,mass)/drag_coefficient;
+    return acceleration * power(vp,mass)/drag_coefficient;
   }
   else {
     return -1;
   }
 }
 
+/**
+ * A function to calculate ballistic retardation values based on standard drag functions.
+ * @param drag_function    G1, G2, G3, G4, G5, G6, G7, or G8
+ * @param drag_coefficient The coefficient of drag for the projectile for the given drag function.
+ * @param vp               The Velocity of the projectile.
+ * @return The function returns the projectile drag retardation velocity, in ft/s per second.
+ */
+static inline double retard(DragFunction drag_function, double drag_coefficient, double vp) {
+  return retard_with(drag_function, drag_coefficient, vp, pow);
+}
+
+/**
+ * retard() with fast_pow() in place of pow(), for BALLISTICS_MATH_FAST.  Within 1e-13 relative of retard() over the
+ * whole 0-10000 fps envelope, for every drag function (fastmath.h).
+ * @param drag_function    G1, G2, G3, G4, G5, G6, G7, or G8
+ * @param drag_coefficient The coefficient of drag for the projectile for the given drag function.
+ * @param vp               The Velocity of the projectile.
+ * @return The projectile drag retardation velocity, in ft/s per second, or -1 wherever retard() is -1.
+ */
+static inline double retard_fast(DragFunction drag_function, double drag_coefficient, double vp) {
+  return retard_with(drag_function, drag_coefficient, vp, fast_pow);
+}
+
+/**
+ * retard() evaluated from a precomputed table instead of pow(): an indexed lookup and a cubic polynomial.
+ * Each drag function's table (160 KB, cache-line aligned) is built on first use and is safe to share between threads.
+ * The maximum relative error against retard() is 1e-10 over the whole 0-10000 fps envelope, for every drag function.
+ * Cells below 100 fps, and the few cells that contain a segment boundary, are evaluated with retard() itself.
+ * @param drag_function    G1, G2, G3, G4, G5, G6, G7, or G8
+ * @param drag_coefficient The coefficient of drag for the projectile for the given drag function.
+ * @param vp               The Velocity of the projectile.
+ * @return The projectile drag retardation velocity, in ft/s per second, or -1 wherever retard() is -1.
+ */
+double retard_table(DragFunction drag_function, double drag_coefficient, double vp);
+
+/**
+ * The instruction sets retard_v() can be evaluated with.
+ */
+typedef enum {
+  DRAG_ISA_GENERIC = 0, // portable 2-wide vectors; SSE2 on x86-64
+  DRAG_ISA_AVX2,        // 4-wide
+  DRAG_ISA_AVX512       // 8-wide
+} DragIsa;
+
+/**
+ * Evaluates retard() for n velocities at once.  Segment selection is branch-free (every lane counts the
+ * thresholds it does not exceed and gathers its coefficients by that index) and vp^mass is computed as
+ * exp(mass*log(vp)) with vector polynomials.  The widest instruction set the CPU supports is picked at runtime.
+ * Results agree with retard() to a relative error below 1e-13, and are -1 exactly where retard() is -1.
+ * @param drag_function    G1, G2, G3, G4, G5, G6, G7, or G8
+ * @param drag_coefficient n coefficients of drag, one per velocity.
+ * @param vp               n projectile velocities.
+ * @param out              n retardation values, in ft/s per second.
+ * @param n                The number of velocities.
+ */
+void retard_v(DragFunction drag_function, const double* drag_coefficient, const double* vp, double* out, size_t n);
+
+/**
+ * The instruction set retard_v() dispatches to on this CPU.
+ */
+DragIsa retard_v_best_isa(void);
+
+/**
+ * retard_v() evaluated with a specific instruction set, for testing and benchmarking each kernel.
+ * @return 0 on success, -1 if the CPU does not support isa.
+ */
+int retard_v_isa(DragIsa isa, DragFunction drag_function, const double* drag_coefficient, const double* vp,
+                 double* out, size_t n);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
\ No newline at end of file
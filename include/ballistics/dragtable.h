@@ -0,0 +1,75 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The standard speed of sound, in ft/s, that converts velocity to Mach number for drag tables.
+#define DRAG_TABLE_SPEED_OF_SOUND 1116.45
+// Retardation in ft/s^2 is Cd * v^2 * DRAG_TABLE_RETARDATION / BC, for v in ft/s and BC in lb/in^2.
+#define DRAG_TABLE_RETARDATION 2.08551e-4
+// The Mach spacing tables are resampled to.
+#define DRAG_TABLE_MACH_STEP 0.005
+
+/**
+ * A measured drag curve, such as a Doppler radar Cd-vs-Mach table, for projectiles the G-models do not fit.
+ * The points are joined with a monotone cubic (Fritsch-Carlson) and resampled to a uniform Mach grid, so a
+ * lookup is an index and a linear blend, whatever the number of points or tables.  Beyond the curve's first
+ * and last Mach numbers, Cd is held at the end values.
+ *
+ * Tables are immutable once built and can be shared between threads.  Select one for a solve with
+ * BallisticsOptions.drag_table.
+ */
+typedef struct DragTable DragTable;
+
+/**
+ * @param mach Mach numbers, strictly increasing.
+ * @param cd   The drag coefficient at each Mach number.
+ * @param n    The number of points; at least 2.
+ * @return The table, or NULL if the points are invalid or memory is not available.
+ */
+DragTable* DragTable_create(const double* mach, const double* cd, size_t n);
+
+/**
+ * Loads a table from a text file with one "mach,cd" pair per line.  Pairs may also be separated by spaces,
+ * tabs or semicolons.  Lines that do not start with a pair, such as headers and '#' comments, are skipped.
+ * @return The table, or NULL if the file cannot be read or its points are invalid.
+ */
+DragTable* DragTable_load_csv(const char* path);
+
+void DragTable_free(DragTable* table);
+
+/**
+ * @return The drag coefficient at a Mach number.
+ */
+double DragTable_cd(const DragTable* table, double mach);
+
+/**
+ * The counterpart of retard() for a table.
+ * @param drag_coefficient The ballistic coefficient of the projectile, for this table.
+ * @param vp               The projectile velocity relative to the air, in ft/s.
+ * @return The retardation, in ft/s^2.
+ */
+double DragTable_retard(const DragTable* table, double drag_coefficient, double vp);
+
+#ifdef __cplusplus
+}
+#endif
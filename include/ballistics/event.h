@@ -0,0 +1,60 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "options.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct Ballistics;
+
+/**
+ * Where along a trajectory a quantity reaches a value.  Velocity and time change monotonically over range; the
+ * path rises to the vertex and then falls, and the elevation correction falls to a minimum and then rises, so
+ * for these two only the far side is searched.
+ */
+typedef enum {
+  BALLISTICS_EVENT_VELOCITY = 0, // velocity falls to value, in ft/s; e.g. the speed of sound, for transonic
+  BALLISTICS_EVENT_PATH,         // the path falls to value past the vertex, in inches; e.g. -60 for 60 in of drop
+  BALLISTICS_EVENT_MOA,          // the elevation correction rises to value past its minimum, in MOA
+  BALLISTICS_EVENT_TIME          // time of flight reaches value, in seconds
+} BallisticsEvent;
+
+/**
+ * The range at which event happens in a solution, interpolated linearly between the rows on either side.
+ * The rows are binary searched, in O(log n).  If the quantity is already at value where the search starts, at
+ * the first row or the extremum, that row's range.
+ * @return The range, in yards, or -1 if event does not happen within the solution.
+ */
+double Ballistics_find_event(struct Ballistics* ballistics, BallisticsEvent event, double value);
+
+/**
+ * Ballistics_find_event() on the solution of in at every yard out to max_yards, without solving it: the rows
+ * are checked as the integrator produces them, none are stored, and integration stops at the first row past
+ * event.
+ * @return The range, in yards, or -1 if event does not happen by max_yards.
+ */
+double Ballistics_solve_event(BallisticsEvent event, double value, size_t max_yards, const BallisticsInput* in,
+                              const BallisticsOptions* options);
+
+#ifdef __cplusplus
+}
+#endif
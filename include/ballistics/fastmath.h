@@ -0,0 +1,93 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Table-driven log2, exp2 and pow for the drag power laws, behind BALLISTICS_MATH_FAST.  For positive normal x and
+// |y*log2(x)| < 1000, fast_pow(x, y) is within (2 + |y|*(1 + |log2(x)|))*2*DBL_EPSILON relative of pow(x, y);
+// over the drag functions' segments below 10000 ft/s that is under 1e-13, and 1.3e-14 (59 ulp) is the largest
+// seen (test/fastmath_check.cpp).  Anything else goes to pow().
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// {1/c, log2(c)} for c at the middle of each 1/256 of [1, 2), with 1/c rounded first and its log2 taken exactly.
+extern const double fast_log2_table[256][2];
+// 2^(j/256).
+extern const double fast_exp2_table[256];
+
+/**
+ * log2(x) for positive normal x.  x = m*2^e with m in [1, 2); m is brought within 1/512 of 1 by the reciprocal of
+ * the middle of its 1/256, whose log2 comes from the table, and the rest is log1p(r)/ln(2) to degree 5.  The
+ * polynomial is evaluated in Estrin's form, to keep the dependency chain short.
+ */
+static inline double fast_log2(double x) {
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  int e = (int)((bits >> 52) & 0x7ff) - 1023;
+  const double* cell = fast_log2_table[(bits >> 44) & 255];
+  bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  double m;
+  memcpy(&m, &bits, sizeof(m));
+  double r = m*cell[0] - 1;
+  double r2 = r*r;
+  double p = r*1.4426950408889634 + r2*(-0.7213475204444817 + r*0.4808983469629878)
+           + r2*r2*(-0.36067376022224085 + r*0.28853900817779266);
+  return (e + cell[1]) + p;
+}
+
+/**
+ * exp2(w) for |w| < 1000.  w = k + j/256 + f with |f| <= 1/512; 2^k goes straight into the exponent, 2^(j/256)
+ * comes from the table, and 2^f by its Taylor series to degree 4.  Adding 1.5*2^52 rounds w*256 to an integer
+ * in the low bits without a conversion.
+ */
+static inline double fast_exp2(double w) {
+  const double shifter = 6755399441055744.0; // 1.5*2^52
+  double kd = w*256 + shifter;
+  uint64_t kbits;
+  memcpy(&kbits, &kd, sizeof(kbits));
+  double f = w - (kd - shifter)*(1.0/256);
+  int j = (int)(kbits & 255);
+  // The low bits of kd hold n + 2^51, so n - j, a multiple of 256, shifts straight into the exponent.
+  uint64_t bits = (kbits - (uint64_t)j - 0x0008000000000000ULL) << 44;
+  bits += 0x3ff0000000000000ULL;
+  double scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  double f2 = f*f;
+  double p = (1 + f*0.6931471805599453) + f2*(0.24022650695910072 + f*0.05550410866482158 + f2*0.009618129107628477);
+  return scale*fast_exp2_table[j]*p;
+}
+
+static inline double fast_pow(double x, double y) {
+  if (!(x >= DBL_MIN && x <= DBL_MAX)) {
+    return pow(x, y);
+  }
+  double w = y*fast_log2(x);
+  if (!(fabs(w) < 1000)) {
+    return pow(x, y);
+  }
+  return fast_exp2(w);
+}
+
+#ifdef __cplusplus
+}
+#endif
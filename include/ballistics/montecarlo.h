@@ -0,0 +1,95 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "options.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bins in each impact histogram, spread evenly over [-histogram_span, histogram_span] inches.
+#define BALLISTICS_MC_BINS 64
+
+/**
+ * A dispersion study: the nominal shot, how each input varies from shot to shot, and the targets to score.
+ * Standard deviations of 0 hold an input at its nominal value.
+ */
+typedef struct {
+  // The nominal load, zero and conditions.  The shooter holds for these: each shot aims with the nominal
+  // trajectory's path and windage at the shooter's range estimate.
+  BallisticsInput input;
+  double vi_sd;               // muzzle velocity, ft/s
+  double drag_coefficient_sd; // drag coefficient, as a fraction of the nominal, e.g. 0.02 for 2%
+  double wind_speed_sd;       // mi/hr; varies the input's wind, so it has no effect under a BallisticsOptions.wind
+  double wind_angle_sd;       // degrees
+  double range_sd;            // range estimate, as a fraction of the true range
+  // Target ranges in yards, increasing, and how many.
+  const double* ranges;
+  size_t range_count;
+  // A rectangular target centered on the point of aim, in inches.
+  double target_width;
+  double target_height;
+  // The half-width of the impact histograms, in inches.  0 selects 24.
+  double histogram_span;
+  size_t samples;
+  // Shot i draws its random numbers from stream (seed, i), so results do not depend on threads or scheduling.
+  uint64_t seed;
+  // The number of threads to spread the samples over.  0 or 1 runs on the calling thread.
+  int threads;
+} BallisticsMonteCarlo;
+
+/**
+ * Impacts at one target range, relative to the point of aim, in inches.  Vertical is positive up and
+ * horizontal has the sign of Ballistics_get_windage().
+ */
+typedef struct {
+  double range;        // yards
+  size_t reached;      // shots whose trajectory reached the range; the others count as misses
+  size_t hits;         // shots inside the target
+  double p_hit;        // hits / samples
+  double mean_vertical;
+  double sd_vertical;
+  double mean_horizontal;
+  double sd_horizontal;
+  // Impacts per bin of width 2*histogram_span/BALLISTICS_MC_BINS, from -histogram_span up, and those
+  // beyond either end.
+  unsigned long vertical[BALLISTICS_MC_BINS];
+  unsigned long horizontal[BALLISTICS_MC_BINS];
+  unsigned long vertical_outside[2];   // below, above
+  unsigned long horizontal_outside[2];
+} BallisticsMonteCarloRange;
+
+/**
+ * Runs a dispersion study.  Each thread solves its shots into one reused handle, at the target ranges only,
+ * and streams the impacts into per-range moments and histograms, so memory does not grow with the number of
+ * samples.  Hit counts and histograms are identical for any number of threads; means and standard deviations
+ * agree to rounding.
+ * @param options selects how each shot is solved, as for Ballistics_solve_ranges(), except that options->stats
+ *                is not filled in.  May be NULL.
+ * @param out     mc->range_count results, one per target range.
+ * @return 0 on success, -1 if the study is not well formed or memory is not available.
+ */
+int Ballistics_monte_carlo(const BallisticsMonteCarlo* mc, const BallisticsOptions* options,
+                           BallisticsMonteCarloRange* out);
+
+#ifdef __cplusplus
+}
+#endif
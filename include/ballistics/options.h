@@ -0,0 +1,128 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "atmosphere.h"
+#include "drag.h"
+#include "dragtable.h"
+#include "stats.h"
+#include "wind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The arguments of one Ballistics_solve() call, bundled so that many of them can be solved together.
+ * Each field has the same meaning as the Ballistics_solve() parameter of the same name.
+ */
+typedef struct {
+  DragFunction drag_function;
+  double drag_coefficient;
+  double vi;
+  double sight_height;
+  double shooting_angle;
+  double zero_angle;
+  double wind_speed;
+  double wind_angle;
+} BallisticsInput;
+
+/**
+ * How retardation is evaluated during integration.
+ */
+typedef enum {
+  DRAG_MODE_ANALYTIC = 0, // retard(): the piecewise power laws, evaluated with pow()
+  DRAG_MODE_TABLE         // retard_table(): an indexed lookup and cubic interpolation
+} DragMode;
+
+/**
+ * The numerical integrator used to compute a solution.
+ */
+typedef enum {
+  // A fixed half-foot step with a first-order velocity update.  Each yard is sampled at the first step
+  // that reaches it.
+  BALLISTICS_ENGINE_EULER = 0,
+  // An embedded Dormand-Prince 5(4) pair with error-controlled steps, integrated over range.  Each yard is
+  // sampled exactly, from the pair's continuous extension.
+  BALLISTICS_ENGINE_RK45
+} BallisticsEngine;
+
+/**
+ * How zero_angle_ex() searches for the bore angle.
+ */
+typedef enum {
+  // Step-halving from 14 degrees until the step is below the tolerance; about 20 integrations.
+  ZERO_METHOD_BISECTION = 0,
+  // Secant iteration seeded with the flat-fire estimate, on the path interpolated to exactly the zero range;
+  // usually 3 or 4 integrations.  Falls back to bisection if it cannot make progress.
+  ZERO_METHOD_SECANT
+} ZeroMethod;
+
+/**
+ * How PBR_solve_ex() searches for the bore angle that puts the vertex at the top of the vital zone.
+ */
+typedef enum {
+  // Step-halving from 10 degrees down to 0.01 MOA, integrating the whole trajectory at every angle.  Events
+  // are located at the first step past them.
+  PBR_METHOD_STEP_HALVING = 0,
+  // Illinois root finding on the vertex height, integrating each trial only as far as its vertex, then one
+  // pass that stops once every event has fired.  Events are interpolated within the step that crossed them.
+  PBR_METHOD_ROOT
+} PbrMethod;
+
+/**
+ * How the integrators evaluate powers and speeds.
+ */
+typedef enum {
+  // libm pow() for the drag functions, and speed as the historical pow(pow(vx,2)+pow(vy,2),0.5).
+  BALLISTICS_MATH_EXACT = 0,
+  // fast_pow() for the drag functions, within about 1e-13 relative of pow() (fastmath.h), and speed with sqrt().
+  // Paths at 1000 yards move by under a thousandth of an inch (test/fastmath_check.cpp).
+  BALLISTICS_MATH_FAST
+} BallisticsMath;
+
+/**
+ * Per-call choices for the solvers.  A zero-initialized struct, or a NULL pointer, selects the library's
+ * standard behavior, so new fields never change the results of existing callers.
+ */
+typedef struct {
+  DragMode drag_mode;
+  BallisticsEngine engine;
+  // The relative and absolute error allowed per step by adaptive engines.  0 selects 1e-8.
+  double tolerance;
+  ZeroMethod zero_method;
+  // The bore angle accuracy zero_angle_ex() stops at, in MOA.  0 selects 0.01 MOA.
+  double zero_tolerance;
+  // Receives the call's stats when the library is built with BALLISTICS_INSTRUMENTATION.  NULL skips them.
+  BallisticsStats* stats;
+  PbrMethod pbr_method;
+  // A measured drag curve to use instead of the input's drag function, which is then ignored.  NULL uses the
+  // drag function.
+  const DragTable* drag_table;
+  // Air that varies with height along the trajectory.  NULL keeps the standard sea level air that drag
+  // coefficients, corrected or not, describe.
+  const AtmosphereProfile* atmosphere;
+  // Wind that changes along the range, replacing the input's wind_speed and wind_angle.  NULL uses the input's
+  // wind over the whole range.
+  const WindProfile* wind;
+  // How the integrators evaluate drag powers and speeds.  BALLISTICS_MATH_EXACT keeps earlier results bit for bit.
+  BallisticsMath math;
+} BallisticsOptions;
+
+#ifdef __cplusplus
+}
+#endif
@@ -17,6 +17,9 @@
 #pragma once
 
 #include "drag.h"
+#include "options.h"
+
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -78,6 +81,28 @@ void PBR_free(struct PBR* pbr);
 int PBR_solve(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
               double sight_height, double vital_size);
 
+/**
+ * PBR_solve(), with options.  options->pbr_method selects the search, options->drag_mode the retardation and
+ * options->stats receives the call's stats; NULL options behave exactly like PBR_solve().
+ * @return 0 if pbr exists, or a PBR_E_* code
+ */
+int PBR_solve_ex(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
+                 double sight_height, double vital_size, const BallisticsOptions* options);
+
+/**
+ * Solves one load for several vital zone sizes at once, with the root-finding engine (PBR_METHOD_ROOT).  Every
+ * vertex height integrated while searching for one size brackets the searches for the others, so later sizes
+ * need only one or two vertex integrations.  Each size still integrates its own trajectory past the vertex to
+ * its far zero, so a table of four sizes costs about twice a single PBR_solve_ex(), and a little over half as
+ * much as solving the sizes separately (test/pbr_check.cpp).
+ * @param vital_sizes The vital zone sizes, in inches, in any order.
+ * @param n           The number of sizes.
+ * @param out         Receives n solutions, each freed with PBR_free(); NULL for any size that has no PBR.
+ * @return 0 if every size has a PBR, otherwise the PBR_E_* code of the first that does not.
+ */
+int PBR_solve_many(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                   const double* vital_sizes, size_t n, struct PBR** out);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
\ No newline at end of file
@@ -0,0 +1,340 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// The Euler engine as a C++ template over the floating point type.  The C API runs Solver<double>; Solver<float>
+// is the single precision path for Monte Carlo and sweep workloads, where throughput matters more than the last
+// digits.  Precision alone makes it about 1.3 times as fast as a double solver that also takes sqrt() for the
+// speed; against Solver<double>, which keeps the C engine's pow() expression, it is about twice as fast
+// (bench/solver.cpp).  Measured over G1, G2, G5, G6, G7 and G8 with muzzle velocities from 1000 to 4500 fps, out
+// to 1000 yards, the float path stays within 0.5 in of path, 0.4 ft/s of velocity and 1.3 ms of time of the
+// double solution (test/solver_check.cpp).  Rows are taken at the first step past each yard, so a float row can
+// land on a neighbouring step, half a foot away; compare paths at the row's range.
+
+#include "ballistics.h"
+
+#include <cmath>
+
+namespace ballistics {
+
+/**
+ * The powers and speeds of BALLISTICS_MATH_EXACT: pow(), and for double the historical speed expression, so that
+ * Solver<double> reproduces the C engine bit for bit.
+ */
+struct ExactMath {
+  template <typename T>
+  static T pow(T x, T y) { return std::pow(x, y); }
+  static double speed(double vx, double vy) { return std::pow(std::pow(vx,2)+std::pow(vy,2),0.5); }
+  static float speed(float vx, float vy) { return std::sqrt(vx*vx + vy*vy); }
+};
+
+/**
+ * The powers and speeds of BALLISTICS_MATH_FAST: fast_pow(), evaluated in double, and sqrt().
+ */
+struct FastMath {
+  template <typename T>
+  static T pow(T x, T y) { return T(fast_pow(x, y)); }
+  template <typename T>
+  static T speed(T vx, T vy) { return std::sqrt(vx*vx + vy*vy); }
+};
+
+/**
+ * The first segment, in [Lo, Hi), whose threshold vp exceeds, or Hi if there is none.  Model::threshold is
+ * constexpr and descending, so the bisection unrolls at compile time into a few comparisons against constants.
+ */
+template <int Lo, int Hi>
+struct SegmentSearch {
+  template <typename Model, typename T>
+  static int find(T vp) {
+    return vp > Model::threshold[(Lo + Hi)/2] ? SegmentSearch<Lo, (Lo + Hi)/2>::template find<Model>(vp)
+                                              : SegmentSearch<(Lo + Hi)/2 + 1, Hi>::template find<Model>(vp);
+  }
+};
+
+template <int N>
+struct SegmentSearch<N, N> {
+  template <typename Model, typename T>
+  static int find(T) {
+    return N;
+  }
+};
+
+/**
+ * A standard drag function with its segments as constexpr tables, so that retard() needs neither a switch on
+ * the drag function nor a walk down its segments.  Defined for G1, G2, G5, G6, G7 and G8.
+ */
+template <DragFunction F, typename = void>
+struct DragModel;
+
+#define BALLISTICS_DRAG_COUNT(threshold, a, m) + 1
+#define BALLISTICS_DRAG_THRESHOLD(threshold, a, m) threshold,
+#define BALLISTICS_DRAG_ACCELERATION(threshold, a, m) a,
+#define BALLISTICS_DRAG_MASS(threshold, a, m) m,
+#define BALLISTICS_DRAG_MODEL(name) \
+  template <typename D> \
+  struct DragModel<name, D> { \
+    static constexpr int segments = 0 DRAG_##name##_SEGMENTS(BALLISTICS_DRAG_COUNT); \
+    static constexpr double threshold[] = { DRAG_##name##_SEGMENTS(BALLISTICS_DRAG_THRESHOLD) }; \
+    static constexpr double acceleration[] = { DRAG_##name##_SEGMENTS(BALLISTICS_DRAG_ACCELERATION) }; \
+    static constexpr double mass[] = { DRAG_##name##_SEGMENTS(BALLISTICS_DRAG_MASS) }; \
+    /* retard(name, drag_coefficient, vp), evaluated in T with Math's pow(). */ \
+    template <typename T, typename Math = ExactMath> \
+    static T retard(T drag_coefficient, T vp) { \
+      int s = SegmentSearch<0, segments>::template find<DragModel>(vp); \
+      if (s < segments && vp > 0 && vp < 10000) { \
+        return T(acceleration[s]) * Math::pow(vp, T(mass[s]))/drag_coefficient; \
+      } \
+      return -1; \
+    } \
+  }; \
+  template <typename D> constexpr int DragModel<name, D>::segments; \
+  template <typename D> constexpr double DragModel<name, D>::threshold[]; \
+  template <typename D> constexpr double DragModel<name, D>::acceleration[]; \
+  template <typename D> constexpr double DragModel<name, D>::mass[];
+
+BALLISTICS_DRAG_MODEL(G1)
+BALLISTICS_DRAG_MODEL(G2)
+BALLISTICS_DRAG_MODEL(G5)
+BALLISTICS_DRAG_MODEL(G6)
+BALLISTICS_DRAG_MODEL(G7)
+BALLISTICS_DRAG_MODEL(G8)
+
+#undef BALLISTICS_DRAG_COUNT
+#undef BALLISTICS_DRAG_THRESHOLD
+#undef BALLISTICS_DRAG_ACCELERATION
+#undef BALLISTICS_DRAG_MASS
+#undef BALLISTICS_DRAG_MODEL
+
+/**
+ * retard() evaluated in T.  retard<double>() is retard(), and retard<double, FastMath>() is retard_fast().
+ * @return The retardation, in ft/s per second, or -1 wherever retard() is -1.
+ */
+template <typename T, typename Math = ExactMath>
+inline T retard(DragFunction drag_function, T drag_coefficient, T vp) {
+  switch(drag_function) {
+    case G1: return DragModel<G1>::template retard<T, Math>(drag_coefficient, vp);
+    case G2: return DragModel<G2>::template retard<T, Math>(drag_coefficient, vp);
+    case G5: return DragModel<G5>::template retard<T, Math>(drag_coefficient, vp);
+    case G6: return DragModel<G6>::template retard<T, Math>(drag_coefficient, vp);
+    case G7: return DragModel<G7>::template retard<T, Math>(drag_coefficient, vp);
+    case G8: return DragModel<G8>::template retard<T, Math>(drag_coefficient, vp);
+    default: return -1;
+  }
+}
+
+/**
+ * One row of a solution: the quantities of BallisticsColumn, in the same units and order.
+ */
+template <typename T>
+struct Row {
+  T range;       // yards
+  T path;        // inches, relative to the line of sight
+  T moa;
+  T time;        // seconds
+  T windage;     // inches
+  T windage_moa;
+  T v;           // ft/s
+  T vx;
+  T vy;
+};
+
+/**
+ * A trajectory integrated in T with a fixed half-foot step and a first-order velocity update; the standard
+ * engine of Ballistics_solve().  Math evaluates powers and speeds: ExactMath, or FastMath for BALLISTICS_MATH_FAST.
+ */
+template <typename T, typename Math = ExactMath>
+class Solver {
+ public:
+  explicit Solver(const BallisticsInput& in)
+    : drag_function_(in.drag_function),
+      drag_coefficient_(in.drag_coefficient),
+      vi_(in.vi),
+      y0_(-in.sight_height/12),
+      vx0_(in.vi * cos(deg_to_rad(in.zero_angle))),
+      vy0_(in.vi * sin(deg_to_rad(in.zero_angle))),
+      gx_(GRAVITY*sin(deg_to_rad((in.shooting_angle + in.zero_angle)))),
+      gy_(GRAVITY*cos(deg_to_rad((in.shooting_angle + in.zero_angle)))),
+      rise_x_(sin(deg_to_rad(in.shooting_angle))),
+      rise_y_(cos(deg_to_rad(in.shooting_angle))),
+      hwind_(headwind(in.wind_speed, in.wind_angle)),
+      cwind_(crosswind(in.wind_speed, in.wind_angle)) {
+  }
+
+  /**
+   * Solves every yard from the muzzle into rows, with the input's drag function evaluated in T.  Dispatches
+   * once to solve<F>().
+   * @param rows  room for count rows
+   * @param steps when not NULL, receives the number of integration steps
+   * @return the number of rows solved; fewer than count if the trajectory turned steeper than 71.5 degrees.
+   */
+  int solve(Row<T>* rows, int count, long* steps = NULL) const {
+    switch (drag_function_) {
+      case G1: return solve<G1>(rows, count, steps);
+      case G2: return solve<G2>(rows, count, steps);
+      case G5: return solve<G5>(rows, count, steps);
+      case G6: return solve<G6>(rows, count, steps);
+      case G7: return solve<G7>(rows, count, steps);
+      case G8: return solve<G8>(rows, count, steps);
+      default: {
+        const Solver& solver = *this;
+        ConstantWind wind = {hwind_};
+        return integrate(
+            Yards{count},
+            [&solver](T vp, T) { return retard<T, Math>(solver.drag_function_, solver.drag_coefficient_, vp); },
+            wind,
+            [&solver, rows](int n, T x, T y, T t, T v, T vx, T vy) { solver.record(rows[n], x, y, t, v, vx, vy); },
+            steps);
+      }
+    }
+  }
+
+  /**
+   * solve() with the loop instantiated for drag function F, which replaces the input's.
+   */
+  template <DragFunction F>
+  int solve(Row<T>* rows, int count, long* steps = NULL) const {
+    const Solver& solver = *this;
+    ConstantWind wind = {hwind_};
+    return integrate(
+        Yards{count},
+        [&solver](T vp, T) { return DragModel<F>::template retard<T, Math>(solver.drag_coefficient_, vp); },
+        wind,
+        [&solver, rows](int n, T x, T y, T t, T v, T vx, T vy) { solver.record(rows[n], x, y, t, v, vx, vy); },
+        steps);
+  }
+
+  /**
+   * The integration loop.  Samples has count(), range(i) in yards and interpolate(): unless interpolate() is
+   * true, row i is recorded at the first step that reaches yard i; otherwise at exactly range(i), interpolated
+   * within the step.  drag(vp, height) is the retardation at air speed vp, height feet above the firing point.
+   * wind.headwind() is the headwind at the current position, and wind.advance(x0, t0, vx0, x1, t1, vx1) follows
+   * the trajectory from range x0 feet, time t0 and velocity vx0 to (x1, t1, vx1), a step or, up to an
+   * interpolated row, part of one.
+   * sink(n, x, y, t, v, vx, vy) receives each row, with x and y in feet.
+   */
+  template <typename Samples, typename Drag, typename Wind, typename Sink>
+  int integrate(const Samples& samples, Drag drag, Wind& wind, Sink sink, long* steps_out) const {
+    T t=0;
+    T dt=0;
+    T v=0;
+    T vx=vx0_, vx1=0, vy=vy0_, vy1=0;
+    T dv=0, dvx=0, dvy=0;
+    T x=0, y=y0_;
+    long steps=0;
+
+    int n = 0;
+    for (t = 0;; t = t + dt) {
+      vx1 = vx;
+      vy1 = vy;
+      v = Math::speed(vx, vy);
+      dt = T(0.5)/v;
+
+      // Compute acceleration using the drag function retardation
+      dv = drag(v+wind.headwind(), x*rise_x_ + y*rise_y_);
+      dvx = -(vx/v)*dv;
+      dvy = -(vy/v)*dv;
+      steps++;
+
+      // Compute velocity, including the resolved gravity vectors.
+      vx = vx + dt*dvx + dt*gx_;
+      vy = vy + dt*dvy + dt*gy_;
+
+      if (!samples.interpolate() && x/3 >= n) {
+        sink(n, x, y, t+dt, v, vx, vy);
+        n++;
+      }
+
+      // Compute position based on average velocity.
+      T x0 = x, y0 = y;
+      x = x + dt * (vx+vx1)/2;
+      y = y + dt * (vy+vy1)/2;
+      if (samples.interpolate()) {
+        // The wind follows the samples, so that each is drifted in the zone it lies in, and then finishes the step.
+        T xw = x0, tw = t, vxw = vx1;
+        for (; n < samples.count() && T(3*samples.range(n)) <= x; n++) {
+          T xs = T(3*samples.range(n));
+          T f = (xs - x0)/(x - x0);
+          T vxs = vx1 + f*(vx - vx1);
+          T vys = vy1 + f*(vy - vy1);
+          wind.advance(xw, tw, vxw, xs, t + f*dt, vxs);
+          xw = xs;
+          tw = t + f*dt;
+          vxw = vxs;
+          sink(n, xs, y0 + f*(y - y0), t + f*dt, std::sqrt(vxs*vxs + vys*vys), vxs, vys);
+        }
+        wind.advance(xw, tw, vxw, x, t+dt, vx);
+      }
+      else {
+        wind.advance(x0, t, vx1, x, t+dt, vx);
+      }
+
+      if (std::fabs(vy)>std::fabs(3*vx) || n>=samples.count()) break;
+    }
+
+    if (steps_out) {
+      *steps_out = steps;
+    }
+    return n;
+  }
+
+ private:
+  struct ConstantWind {
+    T hwind;
+    T headwind() const { return hwind; }
+    void advance(T, T, T, T, T, T) {}
+  };
+
+  struct Yards {
+    int rows;
+    int count() const { return rows; }
+    double range(int i) const { return i; }
+    bool interpolate() const { return false; }
+  };
+
+  // Ballistics_record() in T.
+  void record(Row<T>& row, T x, T y, T t, T v, T vx, T vy) const {
+    T windage_inches = T(windage(cwind_, vi_, x, t));
+    row.range = x/3;
+    row.path = y*12;
+    row.moa = T(-rad_to_moa(atan(y / x)));
+    row.time = t;
+    row.windage = windage_inches;
+    row.windage_moa = T(rad_to_moa(atan((windage_inches/12) / x)));
+    row.v = v;
+    row.vx = vx;
+    row.vy = vy;
+  }
+
+  DragFunction drag_function_;
+  T drag_coefficient_;
+  T vi_;
+  T y0_;
+  T vx0_, vy0_;
+  T gx_, gy_;
+  T rise_x_, rise_y_;
+  T hwind_, cwind_;
+};
+
+/**
+ * Solves in with the integrator instantiated for drag function F, e.g. solve<G7>(in, rows, 1001).
+ */
+template <DragFunction F, typename T>
+int solve(const BallisticsInput& in, Row<T>* rows, int count, long* steps = NULL) {
+  return Solver<T>(in).template solve<F>(rows, count, steps);
+}
+
+} // namespace ballistics
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Instrumentation of the solvers.  Stats are gathered only for calls that ask for them, through
+// BallisticsOptions.stats, or while a callback is registered, and only when the library is built with
+// BALLISTICS_INSTRUMENTATION; otherwise the counters are compiled out, stats are left untouched and callbacks
+// are never made.
+
+/**
+ * The entry point a BallisticsStats describes.
+ */
+typedef enum {
+  BALLISTICS_CALL_SOLVE = 1, // Ballistics_solve() and the other solution builders
+  BALLISTICS_CALL_ZERO_ANGLE,
+  BALLISTICS_CALL_PBR
+} BallisticsCall;
+
+/**
+ * Why a call stopped.
+ */
+typedef enum {
+  BALLISTICS_STOP_NONE = 0,
+  BALLISTICS_STOP_RANGE,       // reached its last requested row, or the range cap
+  BALLISTICS_STOP_STEEP,       // the trajectory turned steeper than vy > 3vx
+  BALLISTICS_STOP_STEP_FAILED, // an adaptive engine could not meet its tolerance
+  BALLISTICS_STOP_CONVERGED,   // an iterative search met its tolerance
+  BALLISTICS_STOP_ANGLE_LIMIT  // zero_angle() passed the 45 degree cutoff
+} BallisticsStop;
+
+typedef struct {
+  BallisticsCall call;
+  BallisticsStop stop;
+  int status;           // the call's return value, e.g. a PBR_E_* code
+  long steps;           // integration steps, including rejected adaptive steps
+  long retard_calls;    // drag function evaluations
+  int iterations;       // outer iterations: bore angles tried by zero_angle() and PBR_solve(); 1 for a solve
+  double wall_seconds;
+} BallisticsStats;
+
+/**
+ * Receives the stats of each instrumented call, on the thread that made it.
+ */
+typedef void (*BallisticsStatsCallback)(const BallisticsStats* stats, void* context);
+
+/**
+ * Registers callback for every solver call, or clears it when callback is NULL.  Set it while no solves are
+ * running.
+ * @param context passed back to callback unchanged
+ */
+void Ballistics_set_stats_callback(BallisticsStatsCallback callback, void* context);
+
+#ifdef __cplusplus
+}
+#endif
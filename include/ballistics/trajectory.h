@@ -0,0 +1,83 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "options.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRAJECTORY_DEFAULT_PATH_TOLERANCE     0.01 // inches
+#define TRAJECTORY_DEFAULT_VELOCITY_TOLERANCE 0.1  // ft/s
+
+/**
+ * A solution stored as piecewise cubic Hermite segments over range instead of a row per yard; a few KB where
+ * the table takes tens.  Knots are placed as the integrator runs, each segment as long as it reproduces every
+ * yard it spans within the tolerances, so no full table is ever built.  Queries at any fractional range or time
+ * find their segment by binary search over the knots.
+ *
+ * Trajectories are immutable once built and can be shared between threads.
+ */
+typedef struct Trajectory Trajectory;
+
+/**
+ * Solves as Ballistics_solve_ranges() would at every yard, fitting the rows as they are produced.
+ * @param max_yards          The furthest yard to solve, as for Ballistics_solve_into().
+ * @param path_tolerance     The error allowed in path and windage, in inches.  0 selects
+ *                           TRAJECTORY_DEFAULT_PATH_TOLERANCE.  Time is held to the time the bullet takes to
+ *                           cover this at the muzzle.
+ * @param velocity_tolerance The error allowed in velocity, in ft/s.  0 selects
+ *                           TRAJECTORY_DEFAULT_VELOCITY_TOLERANCE.
+ * @return The trajectory, or NULL if memory is not available.
+ */
+Trajectory* Trajectory_solve(size_t max_yards, const BallisticsInput* in, const BallisticsOptions* options,
+                             double path_tolerance, double velocity_tolerance);
+
+void Trajectory_free(Trajectory* trajectory);
+
+/**
+ * The solution at a range, as one row of Ballistics_copy_column() values.
+ * @param yards The range, from 0 to Trajectory_get_max_range().
+ * @param row   Receives BALLISTICS_COLUMNS values, indexed by BallisticsColumn.
+ * @return 0, or -1 if yards is outside the trajectory.
+ */
+int Trajectory_at_range(const Trajectory* trajectory, double yards, double* row);
+
+/**
+ * The solution at a time of flight, as for Trajectory_at_range().
+ * @param seconds The time, from 0 to Trajectory_get_max_time().
+ * @return 0, or -1 if seconds is outside the trajectory.
+ */
+int Trajectory_at_time(const Trajectory* trajectory, double seconds, double* row);
+
+// The range of the last knot, in yards.
+double Trajectory_get_max_range(const Trajectory* trajectory);
+
+// The time of flight at the last knot, in seconds.
+double Trajectory_get_max_time(const Trajectory* trajectory);
+
+int Trajectory_get_knots(const Trajectory* trajectory);
+
+// The memory the trajectory holds, in bytes.
+size_t Trajectory_get_size(const Trajectory* trajectory);
+
+#ifdef __cplusplus
+}
+#endif
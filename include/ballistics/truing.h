@@ -0,0 +1,101 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "options.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The parameters Ballistics_truing() can fit, as flags.
+#define BALLISTICS_TRUING_DRAG_COEFFICIENT 1
+#define BALLISTICS_TRUING_VI               2
+
+// Ballistics_truing() status codes.
+#define BALLISTICS_TRUING_E_INVALID        -1 // the problem is not well formed, or memory is not available
+#define BALLISTICS_TRUING_E_UNREACHABLE    -2 // a trajectory did not reach the zero or the farthest observation
+#define BALLISTICS_TRUING_E_MAX_ITERATIONS -3 // the fit was still moving when the iteration limit was reached
+
+/**
+ * An observed impact: the path at range, relative to the line of sight, in inches and negative below it.
+ */
+typedef struct {
+  double range;  // yards
+  double path;   // inches
+  // The observation's standard deviation, in inches; residuals are weighted by its inverse.  0 selects 1.
+  double sd;
+} BallisticsTruingObservation;
+
+/**
+ * A truing problem: the load, with starting guesses for the parameters being fitted, and where it hit.
+ */
+typedef struct {
+  // The projectile, sight and conditions.  drag_coefficient and vi are the starting guesses for whichever of
+  // them are fitted, and the fixed values of the others.
+  BallisticsInput input;
+  // The range the sight was zeroed at, in yards.  Every trial load is zeroed there again, as the rifle was.
+  // 0 holds input.zero_angle fixed instead.
+  double zero_range;
+  // The observations, in ascending order of range, and how many.
+  const BallisticsTruingObservation* observations;
+  size_t observation_count;
+  // BALLISTICS_TRUING_* flags.  0 fits both.
+  int fit;
+  // The fit has converged once a step changes no parameter by more than this fraction of it.  0 selects 1e-6.
+  double tolerance;
+  // 0 selects 50.
+  int max_iterations;
+  // The number of threads the Jacobian's columns are spread over.  0 or 1 runs on the calling thread.
+  int threads;
+} BallisticsTruing;
+
+/**
+ * The fitted load and how well it explains the observations.
+ */
+typedef struct {
+  double drag_coefficient;
+  double vi;          // ft/s
+  double zero_angle;  // degrees; the bore angle of the fitted load at the zero range
+  double rms;         // the root mean square of the weighted residuals
+  int iterations;     // Levenberg-Marquardt iterations
+  int solves;         // trajectories solved out to the farthest observation
+  int zero_solves;    // trajectories integrated to the zero range while zeroing trial loads
+} BallisticsTruingResult;
+
+/**
+ * Fits the drag coefficient, the muzzle velocity, or both, to observed impacts by Levenberg-Marquardt.  Each
+ * residual evaluation zeroes the trial load (with ZERO_METHOD_SECANT, integrating only to the zero range) and
+ * solves it at the observed ranges only, integrating no farther than the last.  The Jacobian is taken by
+ * forward differences, one solve per fitted parameter, and its columns are solved concurrently on
+ * truing->threads threads.  Fitting both parameters to 5 to 10 observations from a rough start usually takes
+ * under 10 iterations and a few dozen solves.
+ * @param options   selects how each trajectory is solved, as for Ballistics_solve_ranges(), except that
+ *                  zero_method, zero_tolerance and stats are set by the fit.  May be NULL.
+ * @param result    receives the best load found, even when the fit does not converge.
+ * @param residuals when not NULL, receives observation_count residuals of that load, observed minus solved
+ *                  path, in inches.
+ * @return 0 once the fit converges, or a BALLISTICS_TRUING_E_* code.
+ */
+int Ballistics_truing(const BallisticsTruing* truing, const BallisticsOptions* options,
+                      BallisticsTruingResult* result, double* residuals);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Wind that changes along the range, as zones each with their own speed and direction; e.g. readings at the
+ * firing point, midrange and the target.  Headwind enters the drag of each step, and crosswind drift is
+ * carried from zone to zone: the bullet enters each zone with the drift and the sideways velocity it had at
+ * the zone's start, and within the zone drag pulls that velocity toward the zone's crosswind, in proportion
+ * to how it slows the bullet downrange.  From the muzzle this is the lag rule, wind_speed*(t - x/vi), so a
+ * profile of one zone gives the same solution as the input's wind_speed and wind_angle, and drift picked up
+ * in one zone keeps growing through calm zones beyond it.
+ *
+ * Profiles are immutable once built and can be shared between threads.  Select one for a solve with
+ * BallisticsOptions.wind.
+ */
+typedef struct WindProfile WindProfile;
+
+/**
+ * @param start_yards Where each zone starts, in yards: 0 for the first, then strictly increasing.  The last
+ *                    zone extends to the end of the trajectory.
+ * @param speed       Each zone's wind speed, in mi/hr.
+ * @param angle       Each zone's wind direction, in degrees, as for Ballistics_solve().
+ * @param n           The number of zones; at least 1.
+ * @return The profile, or NULL if the zones are invalid or memory is not available.
+ */
+WindProfile* WindProfile_create(const double* start_yards, const double* speed, const double* angle, size_t n);
+
+void WindProfile_free(WindProfile* profile);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,304 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define MC_CHUNK 64             // shots a thread claims at a time
+#define MC_DEFAULT_SPAN 24      // inches
+#define MC_HOLD_MARGIN 8        // range estimate standard deviations the nominal trajectory extends past the targets
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"): a counter-based generator,
+// so any shot's numbers can be drawn directly from its index without sharing state between threads.
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+static void philox(uint32_t ctr[4], uint64_t seed) {
+  uint32_t k0 = (uint32_t)seed;
+  uint32_t k1 = (uint32_t)(seed >> 32);
+  for (int round = 0; round < 10; round++) {
+    uint64_t p0 = (uint64_t)PHILOX_M0 * ctr[0];
+    uint64_t p1 = (uint64_t)PHILOX_M1 * ctr[2];
+    uint32_t c0 = (uint32_t)(p1 >> 32) ^ ctr[1] ^ k0;
+    uint32_t c2 = (uint32_t)(p0 >> 32) ^ ctr[3] ^ k1;
+    ctr[1] = (uint32_t)p1;
+    ctr[3] = (uint32_t)p0;
+    ctr[0] = c0;
+    ctr[2] = c2;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
+
+// Four standard normal deviates from block `block` of shot `shot`'s stream, by Box-Muller.
+static void mc_normals(uint64_t seed, uint64_t shot, uint32_t block, double z[4]) {
+  uint32_t c[4] = {(uint32_t)shot, (uint32_t)(shot >> 32), block, 0};
+  philox(c, seed);
+  for (int k = 0; k < 4; k += 2) {
+    double u1 = (c[k] + 1.0) * 0x1p-32; // (0, 1], so the log is finite
+    double u2 = c[k+1] * 0x1p-32;
+    double r = sqrt(-2*log(u1));
+    z[k] = r*cos(2*M_PI*u2);
+    z[k+1] = r*sin(2*M_PI*u2);
+  }
+}
+
+/**
+ * Running moments (Welford) and histograms of the impacts at one range; index 0 is vertical, 1 horizontal.
+ */
+typedef struct {
+  size_t n;
+  size_t hits;
+  double mean[2];
+  double m2[2];
+  unsigned long bins[2][BALLISTICS_MC_BINS];
+  unsigned long outside[2][2];
+} McAccumulator;
+
+static void mc_add(McAccumulator* a, const BallisticsMonteCarlo* mc, double span, double vertical,
+                   double horizontal) {
+  double d[2] = {vertical, horizontal};
+  a->n++;
+  for (int k = 0; k < 2; k++) {
+    double delta = d[k] - a->mean[k];
+    a->mean[k] += delta / a->n;
+    a->m2[k] += delta * (d[k] - a->mean[k]);
+
+    double u = (d[k] + span) * (BALLISTICS_MC_BINS / (2*span));
+    if (!(u >= 0)) a->outside[k][0]++;
+    else if (u >= BALLISTICS_MC_BINS) a->outside[k][1]++;
+    else a->bins[k][(int)u]++;
+  }
+  if (fabs(vertical) <= mc->target_height/2 && fabs(horizontal) <= mc->target_width/2) {
+    a->hits++;
+  }
+}
+
+// Folds from into into, combining the moments as Chan et al. do.
+static void mc_merge(McAccumulator* into, const McAccumulator* from) {
+  if (from->n == 0) return;
+  double n = (double)into->n + from->n;
+  for (int k = 0; k < 2; k++) {
+    double delta = from->mean[k] - into->mean[k];
+    into->m2[k] += from->m2[k] + delta*delta*((double)into->n*from->n/n);
+    into->mean[k] += delta*from->n/n;
+    for (int b = 0; b < BALLISTICS_MC_BINS; b++) {
+      into->bins[k][b] += from->bins[k][b];
+    }
+    into->outside[k][0] += from->outside[k][0];
+    into->outside[k][1] += from->outside[k][1];
+  }
+  into->n += from->n;
+  into->hits += from->hits;
+}
+
+/**
+ * A study in progress.  The nominal trajectory, every yard, gives the shooter's holds; threads claim shots
+ * from next.
+ */
+typedef struct {
+  const BallisticsMonteCarlo* mc;
+  const BallisticsOptions* options;
+  const double* hold_path;
+  const double* hold_windage;
+  int hold_rows;
+  double span;
+  atomic_size_t next;
+} MonteCarlo;
+
+typedef struct {
+  MonteCarlo* study;
+  McAccumulator* ranges;
+  int status;
+} McWorker;
+
+// A nominal column at a fractional yardage, held at its ends.
+static double mc_hold(const double* column, int rows, double yards) {
+  if (!(yards > 0)) return column[0];
+  if (yards >= rows - 1) return column[rows - 1];
+  int k = (int)yards;
+  double f = yards - k;
+  return column[k] + f*(column[k+1] - column[k]);
+}
+
+static void mc_shot(MonteCarlo* study, Ballistics* shot, size_t i, McAccumulator* ranges) {
+  const BallisticsMonteCarlo* mc = study->mc;
+  double z[4];
+  mc_normals(mc->seed, i, 0, z);
+
+  BallisticsInput in = mc->input;
+  in.vi += mc->vi_sd*z[0];
+  in.drag_coefficient *= 1 + mc->drag_coefficient_sd*z[1];
+  in.wind_speed += mc->wind_speed_sd*z[2];
+  in.wind_angle += mc->wind_angle_sd*z[3];
+
+  int reached = Ballistics_solve_ranges(shot, mc->ranges, mc->range_count, &in, study->options);
+  const double* path = Ballistics_column(shot, BALLISTICS_COL_PATH);
+  const double* windage = Ballistics_column(shot, BALLISTICS_COL_WINDAGE);
+  for (int r = 0; r < reached; r++) {
+    if (r % 4 == 0) {
+      mc_normals(mc->seed, i, 1 + r/4, z);
+    }
+    double estimate = mc->ranges[r] * (1 + mc->range_sd*z[r % 4]);
+    double vertical = path[r] - mc_hold(study->hold_path, study->hold_rows, estimate);
+    double horizontal = windage[r] - mc_hold(study->hold_windage, study->hold_rows, estimate);
+    mc_add(&ranges[r], mc, study->span, vertical, horizontal);
+  }
+}
+
+static void* mc_run(void* arg) {
+  McWorker* worker = (McWorker*)arg;
+  MonteCarlo* study = worker->study;
+  const BallisticsMonteCarlo* mc = study->mc;
+
+  Ballistics* shot = Ballistics_alloc((int)mc->range_count);
+  if (shot == NULL) {
+    worker->status = -1;
+    return NULL;
+  }
+  for (;;) {
+    size_t first = atomic_fetch_add(&study->next, MC_CHUNK);
+    if (first >= mc->samples) break;
+    size_t last = first + MC_CHUNK < mc->samples ? first + MC_CHUNK : mc->samples;
+    for (size_t i = first; i < last; i++) {
+      mc_shot(study, shot, i, worker->ranges);
+    }
+  }
+  Ballistics_free(shot);
+  return NULL;
+}
+
+static int mc_valid(const BallisticsMonteCarlo* mc) {
+  if (mc->samples == 0 || mc->range_count == 0 || mc->range_count > BALLISTICS_COMPUTATION_MAX_YARDS ||
+      mc->ranges == NULL || !(mc->histogram_span >= 0) || !(mc->range_sd >= 0) ||
+      !(mc->target_width >= 0) || !(mc->target_height >= 0)) {
+    return 0;
+  }
+  for (size_t r = 0; r < mc->range_count; r++) {
+    if (!(mc->ranges[r] >= 0) || (r > 0 && mc->ranges[r] < mc->ranges[r-1])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int Ballistics_monte_carlo(const BallisticsMonteCarlo* mc, const BallisticsOptions* options,
+                           BallisticsMonteCarloRange* out) {
+  if (mc == NULL || out == NULL || !mc_valid(mc)) {
+    return -1;
+  }
+
+  // Shots are solved concurrently, so they cannot share one stats record.
+  BallisticsOptions shot_options;
+  memset(&shot_options, 0, sizeof(shot_options));
+  if (options) {
+    shot_options = *options;
+    shot_options.stats = NULL;
+  }
+
+  // The holds: the nominal trajectory every yard, far enough to cover long range estimates.
+  double hold_yards = ceil(mc->ranges[mc->range_count - 1] * (1 + MC_HOLD_MARGIN*mc->range_sd)) + 1;
+  if (hold_yards > BALLISTICS_COMPUTATION_MAX_YARDS - 1) {
+    hold_yards = BALLISTICS_COMPUTATION_MAX_YARDS - 1;
+  }
+  Ballistics* nominal = Ballistics_create((size_t)hold_yards);
+  if (nominal == NULL) {
+    return -1;
+  }
+  int hold_rows = Ballistics_solve_steps(nominal, 0, 1, hold_yards, &mc->input, &shot_options);
+  if (hold_rows < 1) {
+    Ballistics_free(nominal);
+    return -1;
+  }
+
+  MonteCarlo study;
+  study.mc = mc;
+  study.options = &shot_options;
+  study.hold_path = Ballistics_column(nominal, BALLISTICS_COL_PATH);
+  study.hold_windage = Ballistics_column(nominal, BALLISTICS_COL_WINDAGE);
+  study.hold_rows = hold_rows;
+  study.span = mc->histogram_span > 0 ? mc->histogram_span : MC_DEFAULT_SPAN;
+  atomic_init(&study.next, 0);
+
+  // Each thread accumulates on its own; the totals are merged once every shot is in.
+  int threads = mc->threads > 1 ? mc->threads : 1;
+  McWorker* workers = calloc(threads, sizeof(McWorker));
+  McAccumulator* accumulators = calloc((size_t)threads * mc->range_count, sizeof(McAccumulator));
+  pthread_t* handles = threads > 1 ? malloc(sizeof(pthread_t) * (threads - 1)) : NULL;
+  if (workers == NULL || accumulators == NULL || (threads > 1 && handles == NULL)) {
+    free(workers);
+    free(accumulators);
+    free(handles);
+    Ballistics_free(nominal);
+    return -1;
+  }
+  for (int t = 0; t < threads; t++) {
+    workers[t].study = &study;
+    workers[t].ranges = accumulators + (size_t)t * mc->range_count;
+  }
+
+  // The calling thread always works too, so a worker that fails to start only costs parallelism.
+  int started = 0;
+  for (int t = 1; t < threads; t++) {
+    if (pthread_create(&handles[started], NULL, mc_run, &workers[t]) == 0) {
+      started++;
+    }
+  }
+  mc_run(&workers[0]);
+  for (int t = 0; t < started; t++) {
+    pthread_join(handles[t], NULL);
+  }
+
+  int status = 0;
+  for (int t = 0; t < threads; t++) {
+    status |= workers[t].status;
+  }
+  for (int t = 1; t < threads; t++) {
+    for (size_t r = 0; r < mc->range_count; r++) {
+      mc_merge(&accumulators[r], &workers[t].ranges[r]);
+    }
+  }
+
+  for (size_t r = 0; r < mc->range_count && status == 0; r++) {
+    const McAccumulator* a = &accumulators[r];
+    BallisticsMonteCarloRange* result = &out[r];
+    result->range = mc->ranges[r];
+    result->reached = a->n;
+    result->hits = a->hits;
+    result->p_hit = (double)a->hits / mc->samples;
+    result->mean_vertical = a->mean[0];
+    result->sd_vertical = a->n > 1 ? sqrt(a->m2[0] / (a->n - 1)) : 0;
+    result->mean_horizontal = a->mean[1];
+    result->sd_horizontal = a->n > 1 ? sqrt(a->m2[1] / (a->n - 1)) : 0;
+    memcpy(result->vertical, a->bins[0], sizeof(result->vertical));
+    memcpy(result->horizontal, a->bins[1], sizeof(result->horizontal));
+    memcpy(result->vertical_outside, a->outside[0], sizeof(result->vertical_outside));
+    memcpy(result->horizontal_outside, a->outside[1], sizeof(result->horizontal_outside));
+  }
+
+  free(workers);
+  free(accumulators);
+  free(handles);
+  Ballistics_free(nominal);
+  return status == 0 ? 0 : -1;
+}
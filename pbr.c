@@ -14,9 +14,10 @@
  * limitations under the License.
  */
 
-#include "ballistics/ballistics.h"
+#include "ballistics_private.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 /**
@@ -57,8 +58,127 @@ void PBR_free(struct PBR* pbr) {
   free(pbr);
 }
 
-int PBR_solve(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
-              double sight_height, double vital_size) {
+#define PBR_MAX_RANGE (3.0*BALLISTICS_COMPUTATION_MAX_YARDS) // feet
+#define PBR_MAX_ANGLE 45.0           // degrees
+#define PBR_FIRST_ANGLE 0.25         // degrees; the first guess at the top of the bracket
+#define PBR_ANGLE_TOLERANCE 1e-6     // degrees
+#define PBR_HEIGHT_TOLERANCE 1e-3    // square root of inches
+#define PBR_MAX_ITERATIONS 100
+#define PBR_MAX_SAMPLES 256
+
+static int pbr_result(struct PBR** pbr, double near_zero, double far_zero, double min_range, double max_range,
+                      int sight_in_at_100yards) {
+  *pbr = malloc(sizeof(struct PBR));
+  if (*pbr == NULL) {
+    return -1;
+  }
+  (*pbr)->near_zero_yards = (int)(near_zero/3);
+  (*pbr)->far_zero_yards = (int)(far_zero/3);
+  (*pbr)->min_PBR_yards = (int)(min_range/3);
+  (*pbr)->max_PBR_yards = (int)(max_range/3);
+  (*pbr)->sight_in_at_100yards = sight_in_at_100yards;
+  return 0;
+}
+
+/**
+ * Vertex heights already integrated, shared by the searches for several vital sizes.  The height grows with the
+ * bore angle, so the samples from one size bracket and seed the search for the next.
+ */
+typedef struct {
+  double angle[PBR_MAX_SAMPLES];
+  double height[PBR_MAX_SAMPLES];
+  int count;
+} PbrSamples;
+
+/**
+ * A trajectory on level ground for the root-finding engine, stepped the same way as the step-halving search,
+ * with the events it has passed so far.  Event ranges are in feet, and negative until they fire.
+ */
+typedef struct {
+  const BallisticsOptions* options;
+  DragFunction drag_function;
+  double drag_coefficient;
+  double vi;
+  double sight_height;
+  double vital_size;
+  BallisticsStats* stats;
+  PbrSamples* samples; // every vertex height integrated
+
+  double angle;  // the bore angle found by pbr_search(), in degrees
+  double traced; // the bore angle of the trajectory below
+  double x, y, vx, vy, dt;
+  double gx, gy;
+
+  double near_zero, far_zero;
+  double min_range, max_range;
+  int tin100;
+  int tin_kept;
+} PbrTrajectory;
+
+static void pbr_trajectory_init(PbrTrajectory* tr, const BallisticsOptions* options, DragFunction drag_function,
+                                double drag_coefficient, double vi, double sight_height, double vital_size,
+                                BallisticsStats* stats, PbrSamples* samples) {
+  memset(tr, 0, sizeof(*tr));
+  tr->options = options;
+  tr->drag_function = drag_function;
+  tr->drag_coefficient = drag_coefficient;
+  tr->vi = vi;
+  tr->sight_height = sight_height;
+  tr->vital_size = vital_size;
+  tr->stats = stats;
+  tr->samples = samples;
+}
+
+static void pbr_start(PbrTrajectory* tr, double angle) {
+  tr->traced = angle;
+  tr->gy = GRAVITY*cos(deg_to_rad(angle));
+  tr->gx = GRAVITY*sin(deg_to_rad(angle));
+  tr->vx = tr->vi*cos(deg_to_rad(angle));
+  tr->vy = tr->vi*sin(deg_to_rad(angle));
+  tr->x = 0;
+  tr->y = -tr->sight_height/12;
+
+  tr->near_zero = tr->far_zero = -1;
+  tr->min_range = 12*tr->y > -tr->vital_size/2 ? 0 : -1;
+  tr->max_range = -1;
+  tr->tin100 = 0;
+  tr->tin_kept = 0;
+}
+
+// One step, locating any event it passes by interpolating within the step.
+static void pbr_advance(PbrTrajectory* tr) {
+  double x0 = tr->x, y0 = tr->y;
+  double vx1 = tr->vx, vy1 = tr->vy;
+  double v = sqrt(vx1*vx1 + vy1*vy1);
+  double dt = 0.5/v;
+  double dv = Ballistics_retard_at(tr->options, tr->drag_function, tr->drag_coefficient, v, tr->y);
+  BALLISTICS_PROBE(if (tr->stats) { tr->stats->steps++; tr->stats->retard_calls++; });
+
+  tr->vx = vx1 - dt*(vx1/v)*dv + dt*tr->gx;
+  tr->vy = vy1 - dt*(vy1/v)*dv + dt*tr->gy;
+  tr->x += dt*(tr->vx + vx1)/2;
+  tr->y += dt*(tr->vy + vy1)/2;
+  tr->dt = dt;
+
+  double x = tr->x, y = tr->y;
+  double edge = -tr->vital_size/24; // the bottom of the vital zone, in feet
+#define PBR_CROSSING(level) (x0 + ((level) - y0)*(x - x0)/(y - y0))
+  if (tr->near_zero < 0 && y0 <= 0 && y > 0) tr->near_zero = PBR_CROSSING(0);
+  if (tr->near_zero >= 0 && tr->far_zero < 0 && y0 >= 0 && y < 0) tr->far_zero = PBR_CROSSING(0);
+  if (tr->min_range < 0 && y0 <= edge && y > edge) tr->min_range = PBR_CROSSING(edge);
+  if (tr->min_range >= 0 && tr->max_range < 0 && y0 >= edge && y < edge) tr->max_range = PBR_CROSSING(edge);
+#undef PBR_CROSSING
+  if (!tr->tin_kept && x >= 300) {
+    tr->tin100 = (int)(100*12*(y0 + (300 - x0)*(y - y0)/(x - x0)));
+    tr->tin_kept = 1;
+  }
+}
+
+// The historical search: step-halving on the bore angle until the step is under 0.01 MOA, integrating the whole
+// trajectory at every angle.
+static int pbr_step_halving(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
+                            double sight_height, double vital_size, const BallisticsOptions* options,
+                            BallisticsStats* stats) {
 
   double t=0;
   double dt=0.5/vi;
@@ -93,6 +213,7 @@ int PBR_solve(struct PBR** pbr, DragFunction drag_function, double drag_coeffici
   int status = 0;
 
   while (quit==0){
+    BALLISTICS_PROBE(if (stats) stats->iterations++);
 
     Gy=GRAVITY*cos(deg_to_rad((ShootingAngle + ZAngle)));
     Gx=GRAVITY*sin(deg_to_rad((ShootingAngle + ZAngle)));
@@ -120,11 +241,12 @@ int PBR_solve(struct PBR** pbr, DragFunction drag_function, double drag_coeffici
       status = 0;
 
       vx1=vx, vy1=vy;
-      v=pow(pow(vx,2)+pow(vy,2),0.5);
+      v = options->math == BALLISTICS_MATH_FAST ? sqrt(vx*vx + vy*vy) : pow(pow(vx,2)+pow(vy,2),0.5);
       dt=0.5/v;
 
       // Compute acceleration using the drag function retardation
-      dv = retard(drag_function,drag_coefficient,v);
+      dv = Ballistics_retard_at(options, drag_function, drag_coefficient, v, y);
+      BALLISTICS_PROBE(if (stats) { stats->steps++; stats->retard_calls++; });
       dvx = -(vx/v)*dv;
       dvy = -(vy/v)*dv;
 
@@ -200,12 +322,219 @@ int PBR_solve(struct PBR** pbr, DragFunction drag_function, double drag_coeffici
     return status;
   }
 
-  *pbr = malloc(sizeof(struct PBR));
-  (*pbr)->near_zero_yards = (int)(zero/3);
-  (*pbr)->far_zero_yards = (int)(farzero/3);
-  (*pbr)->min_PBR_yards = (int)(min_PBR_range/3);
-  (*pbr)->max_PBR_yards = (int)(max_PBR_range/3);
-  (*pbr)->sight_in_at_100yards = tin100;
+  return pbr_result(pbr, zero, farzero, min_PBR_range, max_PBR_range, tin100);
+}
+
+// The vertex height above the line of sight, in inches, for a bore angle in degrees.  Integration stops just
+// past the vertex, leaving the trajectory there for pbr_events() to continue.
+static double pbr_vertex_inches(PbrTrajectory* tr, double angle) {
+  BALLISTICS_PROBE(if (tr->stats) tr->stats->iterations++);
+  pbr_start(tr, angle);
+  for (;;) {
+    double y0 = tr->y, vy0 = tr->vy;
+    pbr_advance(tr);
+    double height;
+    if (tr->vy < 0) {
+      // vy is linear over the step and y its integral, so the apex is where vy crosses zero.
+      double f = vy0 / (vy0 - tr->vy);
+      height = 12*(y0 + tr->dt*(vy0*f + (tr->vy - vy0)*f*f/2));
+    }
+    else if (fabs(tr->vy)>fabs(3*tr->vx) || tr->x > PBR_MAX_RANGE) {
+      height = INFINITY; // never turns over within range: far too high
+    }
+    else {
+      continue;
+    }
+
+    PbrSamples* samples = tr->samples;
+    if (samples->count < PBR_MAX_SAMPLES) {
+      samples->angle[samples->count] = angle;
+      samples->height[samples->count] = height;
+      samples->count++;
+    }
+    return height;
+  }
+}
 
+// Finds the bore angle, in degrees, whose vertex is half the vital zone above the line of sight, and stores it
+// in tr->angle.  The search starts from the samples already integrated: the closest on each side bracket the
+// root, and the two closest in height seed a secant step.  Secant steps that leave the bracket fall back to
+// regula falsi.
+//
+// Measured from the bore line at the muzzle, the vertex height grows about as the square of the angle, so the
+// search runs on its square root, which is nearly linear and lets the secant steps converge in one or two.
+static int pbr_search(PbrTrajectory* tr) {
+  PbrSamples* samples = tr->samples;
+  double target = sqrt(tr->vital_size/2 + tr->sight_height);
+  if (samples->count == 0) {
+    pbr_vertex_inches(tr, 0);
+  }
+#define PBR_ERROR(height) (sqrt(fmax((height) + tr->sight_height, 0)) - target)
+
+  double lo = 0, g_lo = -INFINITY, hi = INFINITY, g_hi = INFINITY;
+  double a0 = NAN, g0 = INFINITY, a1 = NAN, g1 = INFINITY; // a1 is the closest to the target, a0 the next
+  for (int k = 0; k < samples->count; k++) {
+    double a = samples->angle[k], g = PBR_ERROR(samples->height[k]);
+    if (g < 0 && a >= lo) {
+      lo = a;
+      g_lo = g;
+    }
+    else if (g >= 0 && a < hi) {
+      hi = a;
+      g_hi = g;
+    }
+    if (fabs(g) < fabs(g1)) {
+      a0 = a1, g0 = g1;
+      a1 = a, g1 = g;
+    }
+    else if (fabs(g) < fabs(g0)) {
+      a0 = a, g0 = g;
+    }
+  }
+
+  while (isinf(hi)) {
+    if (lo >= PBR_MAX_ANGLE) {
+      return PBR_E_OUT_OF_RANGE;
+    }
+    double a = lo > 0 ? fmin(2*lo, PBR_MAX_ANGLE) : PBR_FIRST_ANGLE;
+    double g = PBR_ERROR(pbr_vertex_inches(tr, a));
+    a0 = a1, g0 = g1;
+    a1 = a, g1 = g;
+    if (g < 0) {
+      lo = a;
+      g_lo = g;
+    }
+    else {
+      hi = a;
+      g_hi = g;
+    }
+  }
+
+  for (int i = 0; i < PBR_MAX_ITERATIONS && fabs(g1) >= PBR_HEIGHT_TOLERANCE && hi - lo > PBR_ANGLE_TOLERANCE;
+       i++) {
+    double a = isfinite(g0) && isfinite(g1) && g0 != g1 ? a1 - g1*(a1 - a0)/(g1 - g0) : NAN;
+    if (!(a > lo && a < hi)) {
+      a = isfinite(g_hi) ? (lo*g_hi - hi*g_lo)/(g_hi - g_lo) : (lo + hi)/2;
+      if (!(a > lo && a < hi)) {
+        a = (lo + hi)/2;
+      }
+    }
+    double g = PBR_ERROR(pbr_vertex_inches(tr, a));
+    a0 = a1, g0 = g1;
+    a1 = a, g1 = g;
+    if (g < 0) {
+      lo = a;
+      g_lo = g;
+    }
+    else {
+      hi = a;
+      g_hi = g;
+    }
+  }
+
+#undef PBR_ERROR
+
+  tr->angle = a1;
   return 0;
+}
+
+// Integrates at tr->angle until every PBR event has fired, continuing from the vertex when the last trajectory
+// integrated was at that angle.
+static int pbr_events(PbrTrajectory* tr, struct PBR** pbr) {
+  if (tr->traced != tr->angle) {
+    pbr_start(tr, tr->angle);
+  }
+
+  for (;;) {
+    if (tr->far_zero >= 0 && tr->max_range >= 0 && tr->tin_kept) {
+      return pbr_result(pbr, tr->near_zero, tr->far_zero, tr->min_range, tr->max_range, tr->tin100);
+    }
+    if (fabs(tr->vy)>fabs(3*tr->vx)) {
+      return PBR_E_TOO_FAST_VY;
+    }
+    if (tr->x > PBR_MAX_RANGE) {
+      return PBR_E_OUT_OF_RANGE;
+    }
+    pbr_advance(tr);
+  }
+}
+
+// Root finding on the vertex height, then the events, picking up from the search's last trajectory.
+static int pbr_root(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
+                    double sight_height, double vital_size, const BallisticsOptions* options,
+                    BallisticsStats* stats) {
+  PbrSamples samples;
+  samples.count = 0;
+  PbrTrajectory tr;
+  pbr_trajectory_init(&tr, options, drag_function, drag_coefficient, vi, sight_height, vital_size, stats, &samples);
+  int status = pbr_search(&tr);
+  if (status != 0) {
+    return status;
+  }
+  return pbr_events(&tr, pbr);
+}
+
+int PBR_solve_ex(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
+                 double sight_height, double vital_size, const BallisticsOptions* options) {
+  static const BallisticsOptions defaults;
+  if (options == NULL) {
+    options = &defaults;
+  }
+
+  BallisticsProbe probe;
+  BallisticsStats* stats = BallisticsProbe_begin(&probe, BALLISTICS_CALL_PBR, options);
+
+  int status;
+  if (options->pbr_method == PBR_METHOD_ROOT) {
+    status = pbr_root(pbr, drag_function, drag_coefficient, vi, sight_height, vital_size, options, stats);
+  }
+  else {
+    status = pbr_step_halving(pbr, drag_function, drag_coefficient, vi, sight_height, vital_size, options, stats);
+  }
+
+  BALLISTICS_PROBE(if (stats) {
+    stats->stop = status == PBR_E_TOO_FAST_VY ? BALLISTICS_STOP_STEEP
+                : status == PBR_E_OUT_OF_RANGE ? BALLISTICS_STOP_RANGE
+                : BALLISTICS_STOP_CONVERGED;
+  })
+  BallisticsProbe_end(&probe, stats, status);
+  return status;
+}
+
+int PBR_solve(struct PBR** pbr, DragFunction drag_function, double drag_coefficient, double vi,
+              double sight_height, double vital_size) {
+  return PBR_solve_ex(pbr, drag_function, drag_coefficient, vi, sight_height, vital_size, NULL);
+}
+
+int PBR_solve_many(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                   const double* vital_sizes, size_t n, struct PBR** out) {
+  static const BallisticsOptions defaults;
+  BallisticsProbe probe;
+  BallisticsStats* stats = BallisticsProbe_begin(&probe, BALLISTICS_CALL_PBR, &defaults);
+
+  PbrSamples samples;
+  samples.count = 0;
+  PbrTrajectory tr;
+  pbr_trajectory_init(&tr, &defaults, drag_function, drag_coefficient, vi, sight_height, 0, stats, &samples);
+
+  int first_error = 0;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = NULL;
+    tr.vital_size = vital_sizes[i];
+    int status = pbr_search(&tr);
+    if (status == 0) {
+      status = pbr_events(&tr, &out[i]);
+    }
+    if (status != 0 && first_error == 0) {
+      first_error = status;
+    }
+  }
+
+  BALLISTICS_PROBE(if (stats) {
+    stats->stop = first_error == PBR_E_TOO_FAST_VY ? BALLISTICS_STOP_STEEP
+                : first_error == PBR_E_OUT_OF_RANGE ? BALLISTICS_STOP_RANGE
+                : BALLISTICS_STOP_CONVERGED;
+  })
+  BallisticsProbe_end(&probe, stats, first_error);
+  return first_error;
 }
\ No newline at end of file
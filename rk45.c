@@ -0,0 +1,192 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <math.h>
+
+// The trajectory is integrated over range x (feet), rather than time, so that every yard is a fixed point of
+// the independent variable and can be read straight off the continuous extension.  The state is (t, y, vx, vy).
+#define RK45_DIM 4
+#define RK45_T  0
+#define RK45_Y  1
+#define RK45_VX 2
+#define RK45_VY 3
+
+#define RK45_DEFAULT_TOLERANCE 1e-8
+#define RK45_INITIAL_STEP 1.0 // feet
+#define RK45_MAX_REJECTIONS 50
+
+typedef struct {
+  const BallisticsInput* in;
+  const BallisticsOptions* options;
+  WindCursor wind;
+  double gx, gy;
+  double rise_x, rise_y; // height above the firing point per foot of range and of path
+  long evaluations;
+} Rk45Problem;
+
+// ds/dx for state s at range x.
+static void rk45_derivative(Rk45Problem* p, double x, const double* s, double* ds) {
+  double vx = s[RK45_VX];
+  double vy = s[RK45_VY];
+  double v = sqrt(vx*vx + vy*vy);
+  double dv = Ballistics_retard_at(p->options, p->in->drag_function, p->in->drag_coefficient,
+                                   v + WindCursor_headwind_at(&p->wind, x), x*p->rise_x + s[RK45_Y]*p->rise_y);
+  p->evaluations++;
+
+  double ax = -(vx/v)*dv + p->gx;
+  double ay = -(vy/v)*dv + p->gy;
+  ds[RK45_T] = 1/vx;
+  ds[RK45_Y] = vy/vx;
+  ds[RK45_VX] = ax/vx;
+  ds[RK45_VY] = ay/vx;
+}
+
+// Dormand & Prince, "A family of embedded Runge-Kutta formulae" (1980), with the continuous extension of
+// Hairer, Norsett & Wanner's DOPRI5.
+static const double c2 = 1.0/5, c3 = 3.0/10, c4 = 4.0/5, c5 = 8.0/9;
+static const double a21 = 1.0/5;
+static const double a31 = 3.0/40, a32 = 9.0/40;
+static const double a41 = 44.0/45, a42 = -56.0/15, a43 = 32.0/9;
+static const double a51 = 19372.0/6561, a52 = -25360.0/2187, a53 = 64448.0/6561, a54 = -212.0/729;
+static const double a61 = 9017.0/3168, a62 = -355.0/33, a63 = 46732.0/5247, a64 = 49.0/176, a65 = -5103.0/18656;
+static const double a71 = 35.0/384, a73 = 500.0/1113, a74 = 125.0/192, a75 = -2187.0/6784, a76 = 11.0/84;
+static const double e1 = 71.0/57600, e3 = -71.0/16695, e4 = 71.0/1920, e5 = -17253.0/339200, e6 = 22.0/525,
+                    e7 = -1.0/40;
+static const double d1 = -12715105075.0/11282082432, d3 = 87487479700.0/32700410799,
+                    d4 = -10690763975.0/1880347072, d5 = 701980252875.0/199316789632,
+                    d6 = -1453857185.0/822651844, d7 = 69997945.0/29380423;
+
+int Ballistics_integrate_rk45(Ballistics* ballistics, const BallisticsInput* in, const BallisticsOptions* options,
+                              const BallisticsSamples* samples, BallisticsStats* stats) {
+  double tolerance = options->tolerance > 0 ? options->tolerance : RK45_DEFAULT_TOLERANCE;
+
+  Rk45Problem p;
+  p.in = in;
+  p.options = options;
+  WindCursor_start(&p.wind, options, in);
+  p.gy = GRAVITY*cos(deg_to_rad((in->shooting_angle + in->zero_angle)));
+  p.gx = GRAVITY*sin(deg_to_rad((in->shooting_angle + in->zero_angle)));
+  p.rise_x = sin(deg_to_rad(in->shooting_angle));
+  p.rise_y = cos(deg_to_rad(in->shooting_angle));
+  p.evaluations = 0;
+
+  double s[RK45_DIM], s1[RK45_DIM], tmp[RK45_DIM];
+  double k1[RK45_DIM], k2[RK45_DIM], k3[RK45_DIM], k4[RK45_DIM], k5[RK45_DIM], k6[RK45_DIM], k7[RK45_DIM];
+  double r1[RK45_DIM], r2[RK45_DIM], r3[RK45_DIM], r4[RK45_DIM], r5[RK45_DIM];
+
+  s[RK45_T] = 0;
+  s[RK45_Y] = -in->sight_height/12;
+  s[RK45_VX] = in->vi * cos(deg_to_rad(in->zero_angle));
+  s[RK45_VY] = in->vi * sin(deg_to_rad(in->zero_angle));
+
+  double x = 0;
+  double h = RK45_INITIAL_STEP;
+  int n = 0;
+  int rejections = 0;
+  BALLISTICS_PROBE(long steps = 0);
+
+  rk45_derivative(&p, 0, s, k1);
+
+  for (;;) {
+    int i;
+    for (i = 0; i < RK45_DIM; i++) tmp[i] = s[i] + h*(a21*k1[i]);
+    rk45_derivative(&p, x + c2*h, tmp, k2);
+    for (i = 0; i < RK45_DIM; i++) tmp[i] = s[i] + h*(a31*k1[i] + a32*k2[i]);
+    rk45_derivative(&p, x + c3*h, tmp, k3);
+    for (i = 0; i < RK45_DIM; i++) tmp[i] = s[i] + h*(a41*k1[i] + a42*k2[i] + a43*k3[i]);
+    rk45_derivative(&p, x + c4*h, tmp, k4);
+    for (i = 0; i < RK45_DIM; i++) tmp[i] = s[i] + h*(a51*k1[i] + a52*k2[i] + a53*k3[i] + a54*k4[i]);
+    rk45_derivative(&p, x + c5*h, tmp, k5);
+    for (i = 0; i < RK45_DIM; i++) tmp[i] = s[i] + h*(a61*k1[i] + a62*k2[i] + a63*k3[i] + a64*k4[i] + a65*k5[i]);
+    rk45_derivative(&p, x + h, tmp, k6);
+    for (i = 0; i < RK45_DIM; i++) s1[i] = s[i] + h*(a71*k1[i] + a73*k3[i] + a74*k4[i] + a75*k5[i] + a76*k6[i]);
+    rk45_derivative(&p, x + h, s1, k7);
+    BALLISTICS_PROBE(steps++);
+
+    // Scaled RMS norm of the embedded error estimate.
+    double err = 0;
+    for (i = 0; i < RK45_DIM; i++) {
+      double e = h*(e1*k1[i] + e3*k3[i] + e4*k4[i] + e5*k5[i] + e6*k6[i] + e7*k7[i]);
+      double scale = tolerance + tolerance*fmax(fabs(s[i]), fabs(s1[i]));
+      err += (e/scale)*(e/scale);
+    }
+    err = sqrt(err/RK45_DIM);
+
+    double factor = err > 0 ? 0.9*pow(err, -0.2) : 5;
+    factor = fmin(5, fmax(0.2, factor));
+
+    // A NaN error means the trial step left the domain (vx <= 0); shrink it like any other rejection.
+    if (!(err <= 1)) {
+      h *= err != err ? 0.2 : fmin(1, factor);
+      if (++rejections > RK45_MAX_REJECTIONS) break;
+      continue;
+    }
+    rejections = 0;
+
+    double x1 = x + h;
+
+    // Sample every yard this step covers from the continuous extension.  The wind cursor follows the samples,
+    // so that each is drifted in the zone it lies in, and then finishes the step.
+    double xw = x, tw = s[RK45_T], vxw = s[RK45_VX];
+    if (n < samples->count && 3*BallisticsSamples_range(samples, n) <= x1) {
+      for (i = 0; i < RK45_DIM; i++) {
+        r1[i] = s[i];
+        r2[i] = s1[i] - s[i];
+        r3[i] = h*k1[i] - r2[i];
+        r4[i] = r2[i] - h*k7[i] - r3[i];
+        r5[i] = h*(d1*k1[i] + d3*k3[i] + d4*k4[i] + d5*k5[i] + d6*k6[i] + d7*k7[i]);
+      }
+      for (; n < samples->count && 3*BallisticsSamples_range(samples, n) <= x1; n++) {
+        double xs = 3*BallisticsSamples_range(samples, n);
+        double theta = (xs - x)/h;
+        double theta1 = 1 - theta;
+        for (i = 0; i < RK45_DIM; i++) {
+          tmp[i] = r1[i] + theta*(r2[i] + theta1*(r3[i] + theta*(r4[i] + theta1*r5[i])));
+        }
+        WindCursor_advance(&p.wind, xw, tw, vxw, xs, tmp[RK45_T], tmp[RK45_VX]);
+        xw = xs;
+        tw = tmp[RK45_T];
+        vxw = tmp[RK45_VX];
+        double v = sqrt(tmp[RK45_VX]*tmp[RK45_VX] + tmp[RK45_VY]*tmp[RK45_VY]);
+        Ballistics_record_drift(ballistics, n, xs, tmp[RK45_Y], tmp[RK45_T], v, tmp[RK45_VX], tmp[RK45_VY],
+                                WindCursor_drift(&p.wind, xs, tmp[RK45_T]));
+      }
+    }
+    WindCursor_advance(&p.wind, xw, tw, vxw, x1, s1[RK45_T], s1[RK45_VX]);
+
+    x = x1;
+    for (i = 0; i < RK45_DIM; i++) {
+      s[i] = s1[i];
+      k1[i] = k7[i]; // first same as last
+    }
+
+    if (fabs(s[RK45_VY])>fabs(3*s[RK45_VX]) || n>=samples->count) break;
+
+    h *= factor;
+  }
+
+  ballistics->drag_evaluations = p.evaluations;
+  BALLISTICS_PROBE(if (stats) {
+    stats->steps += steps;
+    stats->retard_calls += p.evaluations;
+    stats->stop = n>=samples->count ? BALLISTICS_STOP_RANGE
+                : rejections > RK45_MAX_REJECTIONS ? BALLISTICS_STOP_STEP_FAILED
+                : BALLISTICS_STOP_STEEP;
+  })
+  return n;
+}
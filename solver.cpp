@@ -0,0 +1,117 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+#include "ballistics/solver.hpp"
+
+namespace {
+
+// BallisticsSamples as Solver::integrate() reads them.
+struct SampleSchedule {
+  const BallisticsSamples* samples;
+  int count() const { return samples->count; }
+  double range(int i) const { return BallisticsSamples_range(samples, i); }
+  bool interpolate() const { return samples->interpolate != 0; }
+};
+
+// Ballistics_retard_at() with the drag function and the math fixed at compile time.
+template <DragFunction F, typename Math>
+struct ModelDrag {
+  const AtmosphereProfile* atmosphere;
+  double drag_coefficient;
+
+  double operator()(double vp, double height) const {
+    if (atmosphere == NULL) {
+      return ballistics::DragModel<F>::template retard<double, Math>(drag_coefficient, vp);
+    }
+    double density, sound;
+    AtmosphereProfile_lookup(atmosphere, height, &density, &sound);
+    return ballistics::DragModel<F>::template retard<double, Math>(drag_coefficient, vp/sound) * sound*sound*density;
+  }
+};
+
+// WindCursor as Solver::integrate() drives it.
+struct Wind {
+  WindCursor cursor;
+  double headwind() const { return cursor.hwind; }
+  void advance(double x0, double t0, double vx0, double x1, double t1, double vx1) {
+    WindCursor_advance(&cursor, x0, t0, vx0, x1, t1, vx1);
+  }
+};
+
+// Runs the solver into ballistics with drag.
+template <typename Math, typename Drag>
+int integrate(const ballistics::Solver<double, Math>& solver, Ballistics* ballistics, const BallisticsSamples* samples,
+              const BallisticsInput* in, const BallisticsOptions* options, Drag drag, long* steps) {
+  Wind wind;
+  WindCursor_start(&wind.cursor, options, in);
+  const WindCursor* cursor = &wind.cursor;
+  return solver.integrate(
+      SampleSchedule{samples},
+      drag,
+      wind,
+      [ballistics, cursor](int row, double x, double y, double t, double v, double vx, double vy) {
+        Ballistics_record_drift(ballistics, row, x, y, t, v, vx, vy, WindCursor_drift(cursor, x, t));
+      },
+      steps);
+}
+
+template <DragFunction F, typename Math>
+int integrate(const ballistics::Solver<double, Math>& solver, Ballistics* ballistics, const BallisticsSamples* samples,
+              const BallisticsInput* in, const BallisticsOptions* options, long* steps) {
+  ModelDrag<F, Math> drag = {options->atmosphere, in->drag_coefficient};
+  return integrate(solver, ballistics, samples, in, options, drag, steps);
+}
+
+template <typename Math>
+int integrate(Ballistics* ballistics, const BallisticsInput* in, const BallisticsOptions* options,
+              const BallisticsSamples* samples, long* steps) {
+  ballistics::Solver<double, Math> solver(*in);
+
+  // The analytic drag functions get a loop of their own; anything else evaluates drag as options say.
+  DragFunction model = options->drag_table == NULL && options->drag_mode == DRAG_MODE_ANALYTIC
+                     ? in->drag_function : G3;
+  switch (model) {
+    case G1: return integrate<G1>(solver, ballistics, samples, in, options, steps);
+    case G2: return integrate<G2>(solver, ballistics, samples, in, options, steps);
+    case G5: return integrate<G5>(solver, ballistics, samples, in, options, steps);
+    case G6: return integrate<G6>(solver, ballistics, samples, in, options, steps);
+    case G7: return integrate<G7>(solver, ballistics, samples, in, options, steps);
+    case G8: return integrate<G8>(solver, ballistics, samples, in, options, steps);
+    default:
+      return integrate(solver, ballistics, samples, in, options, [options, in](double vp, double height) {
+        return Ballistics_retard_at(options, in->drag_function, in->drag_coefficient, vp, height);
+      }, steps);
+  }
+}
+
+} // namespace
+
+int Ballistics_integrate_euler(Ballistics* ballistics, const BallisticsInput* in, const BallisticsOptions* options,
+                               const BallisticsSamples* samples, BallisticsStats* stats) {
+  long steps = 0;
+  int n = options->math == BALLISTICS_MATH_FAST
+        ? integrate<ballistics::FastMath>(ballistics, in, options, samples, &steps)
+        : integrate<ballistics::ExactMath>(ballistics, in, options, samples, &steps);
+
+  ballistics->drag_evaluations = steps;
+  BALLISTICS_PROBE(if (stats) {
+    stats->steps += steps;
+    stats->retard_calls += steps;
+    stats->stop = n>=samples->count ? BALLISTICS_STOP_RANGE : BALLISTICS_STOP_STEEP;
+  })
+  return n;
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <time.h>
+
+static BallisticsStatsCallback stats_callback = NULL;
+static void* stats_context = NULL;
+
+void Ballistics_set_stats_callback(BallisticsStatsCallback callback, void* context) {
+  stats_callback = callback;
+  stats_context = context;
+}
+
+#ifdef BALLISTICS_INSTRUMENTATION
+
+static double seconds_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+BallisticsStats* BallisticsProbe_begin(BallisticsProbe* probe, BallisticsCall call, const BallisticsOptions* options) {
+  probe->out = options ? options->stats : NULL;
+  if (probe->out == NULL && stats_callback == NULL) {
+    return NULL;
+  }
+
+  BallisticsStats zero = {0};
+  probe->stats = zero;
+  probe->stats.call = call;
+  probe->start = seconds_now();
+  return &probe->stats;
+}
+
+void BallisticsProbe_end(BallisticsProbe* probe, BallisticsStats* stats, int status) {
+  if (stats == NULL) {
+    return;
+  }
+
+  stats->status = status;
+  stats->wall_seconds = seconds_now() - probe->start;
+  if (probe->out) {
+    *probe->out = *stats;
+  }
+  if (stats_callback) {
+    stats_callback(stats, stats_context);
+  }
+}
+
+#endif
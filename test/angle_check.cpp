@@ -0,0 +1,102 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <cmath>
+
+namespace {
+  struct Zero {
+    DragFunction drag_function;
+    double drag_coefficient;
+    double vi;
+    double zero_range;
+  };
+
+  class ZeroAngleTest : public ::testing::TestWithParam<Zero> {
+  };
+
+  TEST_P(ZeroAngleTest, SecantAgreesWithBisectionInFewerIterations) {
+    Zero z = GetParam();
+    ZeroResult bisection;
+    ZeroResult secant;
+    BallisticsOptions options = {};
+    options.zero_method = ZERO_METHOD_SECANT;
+
+    ASSERT_EQ(0, zero_angle_ex(z.drag_function, z.drag_coefficient, z.vi, 1.5, z.zero_range, 0, NULL, &bisection));
+    ASSERT_EQ(0, zero_angle_ex(z.drag_function, z.drag_coefficient, z.vi, 1.5, z.zero_range, 0, &options, &secant));
+    // zero_angle()'s one foot step lands close to, but not on, the half-foot trajectory.
+    EXPECT_NEAR(zero_angle(z.drag_function, z.drag_coefficient, z.vi, 1.5, z.zero_range, 0), bisection.angle,
+                moa_to_deg(0.05));
+
+    // Both integrate the same trajectory, so they land within the bisection's last two steps of each other, and
+    // the secant reaches a finer tolerance sooner.
+    EXPECT_NEAR(bisection.angle, secant.angle, moa_to_deg(0.02));
+    EXPECT_LT(secant.tolerance, 0.01);
+    EXPECT_LE(secant.iterations, 5);
+    EXPECT_LT(secant.iterations * 3, bisection.iterations);
+
+    // The solved trajectory crosses the line of sight at the zero range.
+    BallisticsInput in = {z.drag_function, z.drag_coefficient, z.vi, 1.5, 0, secant.angle, 0, 0};
+    Ballistics* solution = Ballistics_create((size_t)z.zero_range);
+    Ballistics_solve_ranges(solution, &z.zero_range, 1, &in, NULL);
+    EXPECT_NEAR(0, Ballistics_get_path(solution, 0), 0.01);
+    Ballistics_free(solution);
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Loads, ZeroAngleTest, ::testing::Values(
+      Zero{G1, 0.5, 1200, 100}, Zero{G1, 0.465, 2750, 200}, Zero{G7, 0.3, 2900, 300}, Zero{G2, 0.4, 2000, 100},
+      Zero{G5, 0.35, 3100, 300}, Zero{G8, 0.45, 2400, 200}));
+
+  TEST(ZeroAngleCheck, SecantHonorsYInterceptInInches) {
+    BallisticsOptions options = {};
+    options.zero_method = ZERO_METHOD_SECANT;
+    options.zero_tolerance = 0.001;
+    ZeroResult high;
+    ASSERT_EQ(0, zero_angle_ex(G1, 0.465, 2750, 1.6, 100, 1.5, &options, &high));
+    EXPECT_LT(high.tolerance, 0.001);
+
+    BallisticsInput in = {G1, 0.465, 2750, 1.6, 0, high.angle, 0, 0};
+    Ballistics* solution = Ballistics_create(100);
+    double range = 100;
+    Ballistics_solve_ranges(solution, &range, 1, &in, NULL);
+    EXPECT_NEAR(1.5, Ballistics_get_path(solution, 0), 0.01);
+    Ballistics_free(solution);
+  }
+
+  TEST(ZeroAngleCheck, BothMethodsTakeYInterceptInInches) {
+    BallisticsOptions secant_options = {};
+    secant_options.zero_method = ZERO_METHOD_SECANT;
+    ZeroResult bisection;
+    ZeroResult secant;
+    ASSERT_EQ(0, zero_angle_ex(G1, 0.465, 2750, 1.6, 100, 1.5, NULL, &bisection));
+    ASSERT_EQ(0, zero_angle_ex(G1, 0.465, 2750, 1.6, 100, 1.5, &secant_options, &secant));
+    EXPECT_NEAR(bisection.angle, secant.angle, moa_to_deg(0.02));
+  }
+
+  TEST(ZeroAngleCheck, SecantFallsBackToBisection) {
+    // Too slow to reach the zero range fired level, so the secant has nothing to work from.
+    BallisticsOptions options = {};
+    options.zero_method = ZERO_METHOD_SECANT;
+    ZeroResult bisection;
+    ZeroResult secant;
+    int status = zero_angle_ex(G1, 0.1, 500, 1.5, 5000, 0, NULL, &bisection);
+    EXPECT_EQ(status, zero_angle_ex(G1, 0.1, 500, 1.5, 5000, 0, &options, &secant));
+    EXPECT_EQ(bisection.angle, secant.angle);
+    EXPECT_GT(secant.iterations, bisection.iterations);
+  }
+} // namespace
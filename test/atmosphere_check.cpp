@@ -0,0 +1,113 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+namespace {
+  BallisticsInput input(double shooting_angle) {
+    BallisticsInput in = {};
+    in.drag_function = G1;
+    in.drag_coefficient = 0.5;
+    in.vi = 2800;
+    in.sight_height = 1.6;
+    in.shooting_angle = shooting_angle;
+    in.zero_angle = 0.1;
+    return in;
+  }
+
+  TEST(AtmosphereProfileTest, StandardMatchesIcaoTables) {
+    AtmosphereProfile* profile = AtmosphereProfile_create_standard(0);
+    ASSERT_NE(nullptr, profile);
+    EXPECT_NEAR(1, AtmosphereProfile_density_ratio(profile, 0), 1e-6);
+    EXPECT_NEAR(0.86167, AtmosphereProfile_density_ratio(profile, 5000), 1e-4);
+    EXPECT_NEAR(0.73848, AtmosphereProfile_density_ratio(profile, 10000), 1e-4);
+    EXPECT_NEAR(0.24617, AtmosphereProfile_density_ratio(profile, 40000), 1e-4);
+    EXPECT_NEAR(1116.45, AtmosphereProfile_speed_of_sound(profile, 0), 1e-3);
+    EXPECT_NEAR(1077.39, AtmosphereProfile_speed_of_sound(profile, 10000), 1e-2);
+    EXPECT_NEAR(968.08, AtmosphereProfile_speed_of_sound(profile, 40000), 1e-2);
+
+    // Heights are measured from the firing point.
+    AtmosphereProfile* mountain = AtmosphereProfile_create_standard(5000);
+    EXPECT_NEAR(AtmosphereProfile_density_ratio(profile, 10000), AtmosphereProfile_density_ratio(mountain, 5000),
+                1e-6);
+    AtmosphereProfile_free(mountain);
+    AtmosphereProfile_free(profile);
+  }
+
+  TEST(AtmosphereProfileTest, HumidAirIsThinner) {
+    AtmosphereProfile* dry = AtmosphereProfile_create(0, 29.92, 80, 0);
+    AtmosphereProfile* humid = AtmosphereProfile_create(0, 29.92, 80, 1);
+    EXPECT_LT(AtmosphereProfile_density_ratio(humid, 0), AtmosphereProfile_density_ratio(dry, 0));
+    AtmosphereProfile_free(dry);
+    AtmosphereProfile_free(humid);
+  }
+
+  TEST(AtmosphereProfileTest, SeaLevelFlatShotMatchesStandardAir) {
+    AtmosphereProfile* profile = AtmosphereProfile_create_standard(0);
+    BallisticsInput in = input(0);
+    BallisticsOptions standard = {};
+    BallisticsOptions varying = {};
+    varying.atmosphere = profile;
+
+    Ballistics* expected = Ballistics_create(1000);
+    Ballistics* actual = Ballistics_create(1000);
+    Ballistics_solve_into(expected, 1000, &in, &standard);
+    Ballistics_solve_into(actual, 1000, &in, &varying);
+    for (int yard = 100; yard <= 1000; yard += 100) {
+      // The path only climbs and drops a few feet, so the air barely changes.
+      EXPECT_NEAR(Ballistics_get_path(expected, yard), Ballistics_get_path(actual, yard), 0.05) << yard;
+    }
+    Ballistics_free(expected);
+    Ballistics_free(actual);
+    AtmosphereProfile_free(profile);
+  }
+
+  TEST(AtmosphereProfileTest, SteepUphillShotsReachThinnerAir) {
+    AtmosphereProfile* profile = AtmosphereProfile_create_standard(0);
+    BallisticsInput in = input(45);
+    BallisticsOptions standard = {};
+    BallisticsOptions varying = {};
+    varying.atmosphere = profile;
+
+    for (int engine = BALLISTICS_ENGINE_EULER; engine <= BALLISTICS_ENGINE_RK45; engine++) {
+      standard.engine = varying.engine = (BallisticsEngine)engine;
+      Ballistics* constant = Ballistics_create(1500);
+      Ballistics* thinning = Ballistics_create(1500);
+      ASSERT_EQ(1501, Ballistics_solve_into(constant, 1500, &in, &standard));
+      ASSERT_EQ(1501, Ballistics_solve_into(thinning, 1500, &in, &varying));
+      EXPECT_GT(Ballistics_get_v_fps(thinning, 1500), Ballistics_get_v_fps(constant, 1500) + 10);
+      Ballistics_free(constant);
+      Ballistics_free(thinning);
+    }
+    AtmosphereProfile_free(profile);
+  }
+
+  TEST(AtmosphereProfileTest, ZeroingAtAltitudeNeedsLessElevation) {
+    AtmosphereProfile* sea_level = AtmosphereProfile_create_standard(0);
+    AtmosphereProfile* mountain = AtmosphereProfile_create_standard(8000);
+    BallisticsOptions options = {};
+    ZeroResult low, high;
+
+    options.atmosphere = sea_level;
+    ASSERT_EQ(0, zero_angle_ex(G1, 0.5, 2800, 1.6, 300, 0, &options, &low));
+    options.atmosphere = mountain;
+    ASSERT_EQ(0, zero_angle_ex(G1, 0.5, 2800, 1.6, 300, 0, &options, &high));
+    EXPECT_LT(high.angle, low.angle);
+    AtmosphereProfile_free(sea_level);
+    AtmosphereProfile_free(mountain);
+  }
+}
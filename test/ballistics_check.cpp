@@ -41,3 +41,251 @@ TEST(BallisticsCheck, PassMe) {
   EXPECT_DOUBLE_EQ(-1229.0334190298465, Ballistics_get_path(solution, 900));
   EXPECT_DOUBLE_EQ(-1580.0152706594765, Ballistics_get_path(solution, 1000));
 }
+
+TEST(BallisticsCheck, TableDragMatchesAnalytic) {
+  BallisticsInput in = {G7, 0.3, 2900, 1.5, 0, 0, 10, 90};
+  in.zero_angle = zero_angle(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0);
+
+  BallisticsOptions analytic = {DRAG_MODE_ANALYTIC};
+  BallisticsOptions table = {DRAG_MODE_TABLE};
+  Ballistics* expected;
+  Ballistics* actual;
+  int nexpected = Ballistics_solve_ex(&expected, &in, &analytic);
+  int nactual = Ballistics_solve_ex(&actual, &in, &table);
+  EXPECT_EQ(nexpected, nactual);
+  for (int yard = 100; yard <= 1000; yard += 100) {
+    EXPECT_NEAR(Ballistics_get_path(expected, yard), Ballistics_get_path(actual, yard), 1e-6);
+    EXPECT_NEAR(Ballistics_get_windage(expected, yard), Ballistics_get_windage(actual, yard), 1e-6);
+    EXPECT_NEAR(Ballistics_get_v_fps(expected, yard), Ballistics_get_v_fps(actual, yard), 1e-6);
+  }
+  Ballistics_free(expected);
+  Ballistics_free(actual);
+}
+
+TEST(BallisticsCheck, SolveIntoStopsAtMaxYards) {
+  BallisticsInput in = {G1, 0.5, 1200, 1.6, 0, 0, 0, 0};
+  in.zero_angle = zero_angle(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0);
+
+  Ballistics* full;
+  Ballistics_solve_ex(&full, &in, NULL);
+
+  // Starts too small, so the first solve grows the handle and the second reuses it.
+  Ballistics* bounded = Ballistics_create(100);
+  ASSERT_TRUE(bounded != NULL);
+  for (int pass = 0; pass < 2; pass++) {
+    ASSERT_EQ(1001, Ballistics_solve_into(bounded, 1000, &in, NULL));
+    for (int yard = 0; yard <= 1000; yard += 50) {
+      EXPECT_EQ(Ballistics_get_time(full, yard), Ballistics_get_time(bounded, yard));
+      EXPECT_EQ(Ballistics_get_path(full, yard), Ballistics_get_path(bounded, yard));
+    }
+    EXPECT_EQ(0, Ballistics_get_path(bounded, 1001));
+    EXPECT_GT(Ballistics_get_drag_evaluations(full), Ballistics_get_drag_evaluations(bounded));
+    Ballistics_reset(bounded);
+    EXPECT_EQ(0, Ballistics_get_path(bounded, 500));
+  }
+
+  Ballistics_free(bounded);
+  Ballistics_free(full);
+}
+
+TEST(BallisticsCheck, ColumnsMatchGetters) {
+  BallisticsInput in = {G1, 0.5, 2600, 1.6, 0, 0, 10, 45};
+  in.zero_angle = zero_angle(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0);
+  Ballistics* solution;
+  int nsoln = Ballistics_solve_ex(&solution, &in, NULL);
+  ASSERT_EQ(nsoln, Ballistics_get_max_yardage(solution));
+
+  const double* path = Ballistics_column_ptr(solution, BALLISTICS_COL_PATH);
+  const double* windage = Ballistics_column_ptr(solution, BALLISTICS_COL_WINDAGE);
+  ASSERT_TRUE(path != NULL);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(path) % 64);
+  EXPECT_TRUE(Ballistics_column_ptr(solution, BALLISTICS_COLUMNS) == NULL);
+  for (int yard = 0; yard < nsoln; yard += 97) {
+    EXPECT_EQ(Ballistics_get_path(solution, yard), path[yard]);
+    EXPECT_EQ(Ballistics_get_windage(solution, yard), windage[yard]);
+  }
+
+  // A dope card: every 25 yards out to 1000, interleaved two columns to a row.
+  double card[41 * 2];
+  for (int i = 0; i <= 40; i++) {
+    ASSERT_EQ(1, Ballistics_copy_column(solution, BALLISTICS_COL_MOA, i * 25, 1, 1, &card[i * 2]));
+    ASSERT_EQ(1, Ballistics_copy_column(solution, BALLISTICS_COL_V, i * 25, 1, 1, &card[i * 2 + 1]));
+  }
+  for (int i = 1; i <= 40; i++) {
+    EXPECT_EQ(Ballistics_get_moa(solution, i * 25), card[i * 2]);
+    EXPECT_EQ(Ballistics_get_v_fps(solution, i * 25), card[i * 2 + 1]);
+  }
+
+  double times[200];
+  EXPECT_EQ(100, Ballistics_copy_column(solution, BALLISTICS_COL_TIME, 300, 100, 2, times));
+  EXPECT_EQ(Ballistics_get_time(solution, 350), times[100]);
+  EXPECT_EQ(10, Ballistics_copy_column(solution, BALLISTICS_COL_TIME, nsoln - 10, 100, 1, times));
+  EXPECT_EQ(0, Ballistics_copy_column(solution, BALLISTICS_COL_TIME, nsoln, 1, 1, times));
+  EXPECT_EQ(0, Ballistics_copy_column(solution, BALLISTICS_COL_TIME, 300, 100, 0, times));
+  EXPECT_EQ(0, Ballistics_copy_column(solution, BALLISTICS_COL_TIME, 300, 100, -1, &times[199]));
+
+  Ballistics_free(solution);
+}
+
+TEST(BallisticsCheck, SparseRangesMatchFullSolution) {
+  BallisticsInput in = {G7, 0.31, 2750, 1.5, 0, 0, 10, 90};
+  in.zero_angle = zero_angle(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0);
+  const double ranges[] = {0, 100, 237, 400, 650.5, 1000};
+
+  // The RK45 engine samples full solutions exactly, so sparse and full rows are the same continuous extension.
+  BallisticsOptions rk45 = {DRAG_MODE_ANALYTIC, BALLISTICS_ENGINE_RK45, 0};
+  Ballistics* full;
+  Ballistics_solve_ex(&full, &in, &rk45);
+  Ballistics* sparse = Ballistics_create(0);
+  ASSERT_EQ(6, Ballistics_solve_ranges(sparse, ranges, 6, &in, &rk45));
+  for (int i = 0; i < 6; i++) {
+    EXPECT_DOUBLE_EQ(ranges[i], Ballistics_get_range(sparse, i));
+    if (ranges[i] == (int)ranges[i]) {
+      EXPECT_NEAR(Ballistics_get_path(full, (int)ranges[i]), Ballistics_get_path(sparse, i), 1e-6);
+      EXPECT_NEAR(Ballistics_get_time(full, (int)ranges[i]), Ballistics_get_time(sparse, i), 1e-9);
+    }
+  }
+  Ballistics_free(full);
+
+  // The Euler engine interpolates within the step that brackets each range, and stops after the last one.
+  Ballistics_solve_ex(&full, &in, NULL);
+  ASSERT_EQ(6, Ballistics_solve_ranges(sparse, ranges, 6, &in, NULL));
+  EXPECT_EQ(-1.5, Ballistics_get_path(sparse, 0));
+  for (int i = 1; i < 6; i++) {
+    EXPECT_DOUBLE_EQ(ranges[i], Ballistics_get_range(sparse, i));
+    if (ranges[i] != (int)ranges[i]) {
+      EXPECT_LT(Ballistics_get_path(full, (int)ranges[i] + 1), Ballistics_get_path(sparse, i));
+      EXPECT_GT(Ballistics_get_path(full, (int)ranges[i]), Ballistics_get_path(sparse, i));
+      continue;
+    }
+    EXPECT_NEAR(Ballistics_get_path(full, (int)ranges[i]), Ballistics_get_path(sparse, i), 0.1);
+    EXPECT_NEAR(Ballistics_get_v_fps(full, (int)ranges[i]), Ballistics_get_v_fps(sparse, i), 1);
+  }
+  EXPECT_LT(Ballistics_get_drag_evaluations(sparse) * 2, Ballistics_get_drag_evaluations(full));
+
+  // A 50 yard dope card.
+  ASSERT_EQ(21, Ballistics_solve_steps(sparse, 0, 50, 1000, &in, NULL));
+  EXPECT_DOUBLE_EQ(750, Ballistics_get_range(sparse, 15));
+  EXPECT_NEAR(Ballistics_get_moa(full, 750), Ballistics_get_moa(sparse, 15), 0.05);
+
+  const double unsorted[] = {100, 50};
+  EXPECT_EQ(-1, Ballistics_solve_ranges(sparse, unsorted, 2, &in, NULL));
+  EXPECT_EQ(-1, Ballistics_solve_steps(sparse, 0, 0, 1000, &in, NULL));
+
+  Ballistics_free(full);
+  Ballistics_free(sparse);
+}
+
+TEST(BallisticsCheck, UpdateCrosswindMatchesFullSolve) {
+  BallisticsInput in = {};
+  in.drag_function = G1;
+  in.drag_coefficient = 0.5;
+  in.vi = 2600;
+  in.sight_height = 1.5;
+  in.zero_angle = zero_angle(G1, 0.5, 2600, 1.5, 100, 0);
+  in.wind_speed = 0;
+
+  Ballistics* eager = Ballistics_create(1000);
+  Ballistics* lazy = Ballistics_create(1000);
+  Ballistics* expected = Ballistics_create(1000);
+  ASSERT_EQ(1001, Ballistics_solve_into(eager, 1000, &in, NULL));
+  ASSERT_EQ(1001, Ballistics_solve_into(lazy, 1000, &in, NULL));
+  EXPECT_EQ(0, Ballistics_get_windage(eager, 500));
+
+  // A pure crosswind leaves the rest of the trajectory alone, so only windage changes.
+  in.wind_speed = 12;
+  in.wind_angle = 90;
+  ASSERT_EQ(1001, Ballistics_solve_into(expected, 1000, &in, NULL));
+  Ballistics_update_crosswind(eager, 12, 90);
+  Ballistics_update_crosswind_lazy(lazy, 12, 90);
+
+  for (int yard = 1; yard <= 1000; yard++) {
+    double windage = Ballistics_get_windage(expected, yard);
+    EXPECT_NEAR(windage, Ballistics_get_windage(eager, yard), 1e-9*fabs(windage)) << yard;
+    EXPECT_NEAR(Ballistics_get_windage_moa(expected, yard), Ballistics_get_windage_moa(eager, yard), 1e-9) << yard;
+    EXPECT_EQ(Ballistics_get_windage(eager, yard), Ballistics_get_windage(lazy, yard)) << yard;
+    EXPECT_EQ(Ballistics_get_windage_moa(eager, yard), Ballistics_get_windage_moa(lazy, yard)) << yard;
+  }
+
+  // The first view of a windage column fills it in.
+  const double* windage = Ballistics_column_ptr(lazy, BALLISTICS_COL_WINDAGE_MOA);
+  const double* eager_windage = Ballistics_column_ptr(eager, BALLISTICS_COL_WINDAGE_MOA);
+  for (int yard = 1; yard <= 1000; yard++) {
+    EXPECT_EQ(eager_windage[yard], windage[yard]) << yard;
+  }
+  EXPECT_EQ(Ballistics_get_windage(eager, 1000), Ballistics_column_ptr(lazy, BALLISTICS_COL_WINDAGE)[1000]);
+
+  // Solving again discards a pending update.
+  Ballistics_update_crosswind_lazy(lazy, 30, 90);
+  in.wind_speed = 0;
+  ASSERT_EQ(1001, Ballistics_solve_into(lazy, 1000, &in, NULL));
+  EXPECT_EQ(0, Ballistics_get_windage(lazy, 500));
+
+  Ballistics_free(eager);
+  Ballistics_free(lazy);
+  Ballistics_free(expected);
+}
+
+TEST(BallisticsCheck, StateAtTimeFollowsTheTimeColumn) {
+  BallisticsInput in = {};
+  in.drag_function = G7;
+  in.drag_coefficient = 0.3;
+  in.vi = 2800;
+  in.sight_height = 1.6;
+  in.zero_angle = zero_angle(G7, 0.3, 2800, 1.6, 100, 0);
+  in.wind_speed = 10;
+  in.wind_angle = 90;
+  Ballistics* solution = Ballistics_create(1000);
+  ASSERT_EQ(1001, Ballistics_solve_into(solution, 1000, &in, NULL));
+  double first = Ballistics_get_time(solution, 0);
+  double last = Ballistics_get_time(solution, 1000);
+
+  // At a row's time, the row itself.
+  double row[BALLISTICS_COLUMNS];
+  for (int yard = 0; yard <= 1000; yard += 50) {
+    ASSERT_EQ(0, Ballistics_state_at_time(solution, Ballistics_get_time(solution, yard), NULL, row));
+    EXPECT_EQ(Ballistics_get_range(solution, yard), row[BALLISTICS_COL_RANGE]) << yard;
+    EXPECT_EQ(Ballistics_get_path(solution, yard), row[BALLISTICS_COL_PATH]) << yard;
+    EXPECT_EQ(Ballistics_get_v_fps(solution, yard), row[BALLISTICS_COL_V]) << yard;
+    EXPECT_DOUBLE_EQ(Ballistics_get_moa(solution, yard), row[BALLISTICS_COL_MOA]) << yard;
+  }
+
+  // Frames at 240 Hz: the cursor finds the same rows as a search from the start.
+  BallisticsTimeCursor cursor = {};
+  double with_cursor[BALLISTICS_COLUMNS];
+  double previous = -1;
+  int frames = 0;
+  for (double t = first; t <= last; t += 1.0/240, frames++) {
+    ASSERT_EQ(0, Ballistics_state_at_time(solution, t, &cursor, with_cursor));
+    ASSERT_EQ(0, Ballistics_state_at_time(solution, t, NULL, row));
+    for (int column = 0; column < BALLISTICS_COLUMNS; column++) {
+      EXPECT_EQ(row[column], with_cursor[column]) << t;
+    }
+    EXPECT_GT(row[BALLISTICS_COL_RANGE], previous);
+    EXPECT_GE(Ballistics_get_time(solution, cursor.row + 1), t);
+    EXPECT_LE(Ballistics_get_time(solution, cursor.row), t);
+    previous = row[BALLISTICS_COL_RANGE];
+  }
+  EXPECT_GT(frames, 200);
+
+  // Going back in time, and the batched form, which takes times in any order.
+  const double times[] = {last, first, 0.5, last + 1, 0.25};
+  double rows[5*BALLISTICS_COLUMNS];
+  EXPECT_EQ(4u, Ballistics_states_at_times(solution, times, 5, rows));
+  for (int k = 0; k < 5; k++) {
+    if (k == 3) {
+      EXPECT_TRUE(std::isnan(rows[3*BALLISTICS_COLUMNS + BALLISTICS_COL_PATH]));
+      continue;
+    }
+    ASSERT_EQ(0, Ballistics_state_at_time(solution, times[k], &cursor, row));
+    for (int column = 0; column < BALLISTICS_COLUMNS; column++) {
+      EXPECT_EQ(row[column], rows[k*BALLISTICS_COLUMNS + column]) << k;
+    }
+  }
+  EXPECT_NEAR(0.5, rows[2*BALLISTICS_COLUMNS + BALLISTICS_COL_TIME], 0);
+
+  EXPECT_EQ(-1, Ballistics_state_at_time(solution, last + 1e-3, &cursor, row));
+  EXPECT_EQ(-1, Ballistics_state_at_time(solution, first - 1e-3, &cursor, row));
+  EXPECT_EQ(-1, Ballistics_state_at_time(solution, NAN, &cursor, row));
+  Ballistics_free(solution);
+}
@@ -0,0 +1,85 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+  std::vector<BallisticsInput> profiles() {
+    std::vector<BallisticsInput> in;
+    const DragFunction drags[] = {G1, G2, G5, G6, G7, G8};
+    for (int i = 0; i < 30; i++) {
+      BallisticsInput p;
+      p.drag_function = drags[i % 6];
+      p.drag_coefficient = 0.25 + 0.02 * i;
+      p.vi = 1100 + 70 * i;
+      p.sight_height = 1.5;
+      p.shooting_angle = (i % 5) * 3 - 6;
+      p.zero_angle = zero_angle(p.drag_function, p.drag_coefficient, p.vi, p.sight_height, 100, 0);
+      p.wind_speed = i % 4 * 5;
+      p.wind_angle = i * 37;
+      in.push_back(p);
+    }
+    return in;
+  }
+
+  // Bitwise agreement, except that the 0/0 rows at the muzzle are NaN in both.
+  bool same(double expected, double actual) {
+    return expected == actual || (std::isnan(expected) && std::isnan(actual));
+  }
+
+  void expectSameAsSolve(const BallisticsInput& p, Ballistics* batched, int batchedYards) {
+    Ballistics* solution;
+    int nsoln = Ballistics_solve(&solution, p.drag_function, p.drag_coefficient, p.vi, p.sight_height,
+                                 p.shooting_angle, p.zero_angle, p.wind_speed, p.wind_angle);
+    ASSERT_EQ(nsoln, batchedYards);
+    for (int yard = 0; yard < nsoln; yard++) {
+      ASSERT_PRED2(same, Ballistics_get_range(solution, yard), Ballistics_get_range(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_path(solution, yard), Ballistics_get_path(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_moa(solution, yard), Ballistics_get_moa(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_time(solution, yard), Ballistics_get_time(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_windage(solution, yard), Ballistics_get_windage(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_windage_moa(solution, yard), Ballistics_get_windage_moa(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_v_fps(solution, yard), Ballistics_get_v_fps(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_vx_fps(solution, yard), Ballistics_get_vx_fps(batched, yard));
+      ASSERT_PRED2(same, Ballistics_get_vy_fps(solution, yard), Ballistics_get_vy_fps(batched, yard));
+    }
+    Ballistics_free(solution);
+  }
+
+  class BatchTest : public ::testing::TestWithParam<int> {
+  };
+
+  TEST_P(BatchTest, MatchesSolve) {
+    std::vector<BallisticsInput> in = profiles();
+    std::vector<Ballistics*> out(in.size());
+    std::vector<int> yards(in.size());
+    ASSERT_EQ(0, Ballistics_solve_batch(in.data(), in.size(), out.data(), yards.data(), GetParam()));
+    for (size_t i = 0; i < in.size(); i++) {
+      expectSameAsSolve(in[i], out[i], yards[i]);
+      Ballistics_free(out[i]);
+    }
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Threads, BatchTest, ::testing::Values(1, 4));
+
+  TEST(BatchCheck, Empty) {
+    EXPECT_EQ(0, Ballistics_solve_batch(NULL, 0, NULL, NULL, 4));
+  }
+} // namespace
@@ -0,0 +1,203 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+  BallisticsInput input(double zero_angle) {
+    BallisticsInput in = {};
+    in.drag_function = G1;
+    in.drag_coefficient = 0.5;
+    in.vi = 2800;
+    in.sight_height = 1.6;
+    in.zero_angle = zero_angle;
+    in.wind_speed = 10;
+    in.wind_angle = 90;
+    return in;
+  }
+
+  double zero_angle_of(DragFunction drag_function, double drag_coefficient, double vi, double sight_height,
+                       double zero_range) {
+    ZeroResult result;
+    zero_angle_ex(drag_function, drag_coefficient, vi, sight_height, zero_range, 0, NULL, &result);
+    return result.angle;
+  }
+
+  TEST(CacheTest, ZeroAngleHitsMatchDirectComputation) {
+    BallisticsCache* cache = BallisticsCache_create(64);
+    ASSERT_NE(nullptr, cache);
+
+    double first = BallisticsCache_zero_angle(cache, G1, 0.5, 2800, 1.6, 100, 0, NULL);
+    // Within a quantization step of the first request, so served from the same entry.
+    double second = BallisticsCache_zero_angle(cache, G1, 0.50001, 2800.01, 1.6, 100, 0, NULL);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(zero_angle_of(G1, 0.5, 2800, 1.6, 100), first);
+
+    BallisticsCacheStats stats;
+    BallisticsCache_get_stats(cache, &stats);
+    EXPECT_EQ(1ul, stats.misses);
+    EXPECT_EQ(1ul, stats.hits);
+    BallisticsCache_free(cache);
+  }
+
+  TEST(CacheTest, FailedZeroSearchesAreNotCached) {
+    BallisticsCache* cache = BallisticsCache_create(64);
+    ASSERT_NE(nullptr, cache);
+
+    // A y-intercept far out of reach below a 45 degree bore angle.
+    ZeroResult result;
+    ASSERT_EQ(-1, zero_angle_ex(G1, 0.5, 2800, 1.6, 100, 1e6, NULL, &result));
+    EXPECT_TRUE(std::isnan(BallisticsCache_zero_angle(cache, G1, 0.5, 2800, 1.6, 100, 1e6, NULL)));
+    EXPECT_TRUE(std::isnan(BallisticsCache_zero_angle(cache, G1, 0.5, 2800, 1.6, 100, 1e6, NULL)));
+
+    BallisticsCacheStats stats;
+    BallisticsCache_get_stats(cache, &stats);
+    EXPECT_EQ(2ul, stats.misses);
+    EXPECT_EQ(0ul, stats.hits);
+    BallisticsCache_free(cache);
+  }
+
+  TEST(CacheTest, SolutionsAreSharedAndOutliveTheCache) {
+    BallisticsCache* cache = BallisticsCache_create(64);
+    BallisticsInput in = input(0.1);
+
+    Ballistics* first = BallisticsCache_solve(cache, 500, &in, NULL);
+    Ballistics* second = BallisticsCache_solve(cache, 500, &in, NULL);
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(first, second);
+    BallisticsCache_free(cache);
+
+    Ballistics* direct = Ballistics_create(500);
+    ASSERT_EQ(501, Ballistics_solve_into(direct, 500, &in, NULL));
+    for (int yard = 0; yard <= 500; yard += 50) {
+      EXPECT_EQ(Ballistics_get_path(direct, yard), Ballistics_get_path(first, yard));
+      EXPECT_EQ(Ballistics_get_windage(direct, yard), Ballistics_get_windage(first, yard));
+    }
+    Ballistics_free(direct);
+    Ballistics_free(first);
+    Ballistics_free(second);
+  }
+
+  double zero_key(int i) {
+    return 0.3 + i*0.001;
+  }
+
+  unsigned long evictions(BallisticsCache* cache) {
+    BallisticsCacheStats stats;
+    BallisticsCache_get_stats(cache, &stats);
+    return stats.evictions;
+  }
+
+  // Finds keys after first that share its stripe: in a cache of one entry per stripe, each evicts first.
+  std::vector<int> same_stripe(int first, size_t count) {
+    std::vector<int> keys = {first};
+    for (int i = first + 1; keys.size() < count; i++) {
+      BallisticsCache* probe = BallisticsCache_create(16);
+      BallisticsCache_zero_angle(probe, G1, zero_key(first), 2800, 1.6, 100, 0, NULL);
+      BallisticsCache_zero_angle(probe, G1, zero_key(i), 2800, 1.6, 100, 0, NULL);
+      if (evictions(probe) == 1) keys.push_back(i);
+      BallisticsCache_free(probe);
+    }
+    return keys;
+  }
+
+  TEST(CacheTest, EvictsLeastRecentlyUsedAtCapacity) {
+    std::vector<int> keys = same_stripe(0, 3);
+    int a = keys[0], b = keys[1], c = keys[2];
+    BallisticsCache* cache = BallisticsCache_create(32); // two entries per stripe
+
+    BallisticsCache_zero_angle(cache, G1, zero_key(a), 2800, 1.6, 100, 0, NULL);
+    BallisticsCache_zero_angle(cache, G1, zero_key(b), 2800, 1.6, 100, 0, NULL);
+    // Touching a makes b, inserted after it, the least recently used; c's insertion must evict b.
+    BallisticsCache_zero_angle(cache, G1, zero_key(a), 2800, 1.6, 100, 0, NULL);
+    BallisticsCache_zero_angle(cache, G1, zero_key(c), 2800, 1.6, 100, 0, NULL);
+    EXPECT_EQ(1ul, evictions(cache));
+
+    BallisticsCacheStats before, after;
+    BallisticsCache_get_stats(cache, &before);
+    BallisticsCache_zero_angle(cache, G1, zero_key(a), 2800, 1.6, 100, 0, NULL);
+    BallisticsCache_get_stats(cache, &after);
+    EXPECT_EQ(before.hits + 1, after.hits) << "the touched key was evicted";
+
+    BallisticsCache_get_stats(cache, &before);
+    BallisticsCache_zero_angle(cache, G1, zero_key(b), 2800, 1.6, 100, 0, NULL);
+    BallisticsCache_get_stats(cache, &after);
+    EXPECT_EQ(before.misses + 1, after.misses) << "the untouched key survived";
+    BallisticsCache_free(cache);
+  }
+
+  TEST(CacheTest, CapacityBoundsTheWholeCache) {
+    const size_t capacities[] = {1, 17};
+    for (size_t capacity : capacities) {
+      BallisticsCache* cache = BallisticsCache_create(capacity);
+      for (int i = 0; i < 64; i++) {
+        BallisticsCache_zero_angle(cache, G1, 0.3 + i*0.001, 2800, 1.6, 100, 0, NULL);
+      }
+      // Newest first, so that everything that survived the first pass is hit before it can be evicted.
+      for (int i = 63; i >= 0; i--) {
+        BallisticsCache_zero_angle(cache, G1, 0.3 + i*0.001, 2800, 1.6, 100, 0, NULL);
+      }
+
+      BallisticsCacheStats stats;
+      BallisticsCache_get_stats(cache, &stats);
+      EXPECT_LE(stats.hits, capacity) << capacity;
+      EXPECT_EQ(128ul, stats.hits + stats.misses);
+      BallisticsCache_free(cache);
+    }
+  }
+
+  TEST(CacheTest, ConcurrentLookupsAgree) {
+    BallisticsCache* cache = BallisticsCache_create(256);
+    const int keys = 32;
+    std::vector<double> expected(keys);
+    for (int k = 0; k < keys; k++) {
+      expected[k] = zero_angle_of(G7, (2000 + k*100)*BALLISTICS_CACHE_BC_STEP, 2600, 1.5, 200);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(8, 0);
+    for (int t = 0; t < 8; t++) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < 4*keys; i++) {
+          int k = (i + t*5) % keys;
+          double angle = BallisticsCache_zero_angle(cache, G7, (2000 + k*100)*BALLISTICS_CACHE_BC_STEP, 2600, 1.5, 200, 0, NULL);
+          if (angle != expected[k]) mismatches[t]++;
+
+          BallisticsInput in = input(0.05 + k*0.001);
+          Ballistics* solution = BallisticsCache_solve(cache, 300, &in, NULL);
+          if (solution == NULL || Ballistics_get_max_yardage(solution) != 301) mismatches[t]++;
+          if (solution) Ballistics_free(solution);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    for (int t = 0; t < 8; t++) {
+      EXPECT_EQ(0, mismatches[t]);
+    }
+    BallisticsCacheStats stats;
+    BallisticsCache_get_stats(cache, &stats);
+    EXPECT_EQ(8ul*4*keys*2, stats.hits + stats.misses);
+    BallisticsCache_free(cache);
+  }
+}
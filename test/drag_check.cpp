@@ -0,0 +1,88 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/drag.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+  const DragFunction kDragFunctions[] = {G1, G2, G3, G4, G5, G6, G7, G8};
+
+  class RetardVTest : public ::testing::TestWithParam<DragIsa> {
+  };
+
+  TEST_P(RetardVTest, MatchesRetard) {
+    // Every whole and half fps across the envelope, plus the edges, in an odd count to exercise the tail.
+    std::vector<double> vp;
+    for (double v = -10; v <= 10010; v += 0.5) {
+      vp.push_back(v);
+    }
+    vp.push_back(4230);
+    vp.push_back(1e-3);
+    std::vector<double> bc(vp.size());
+    for (size_t i = 0; i < bc.size(); i++) {
+      bc[i] = 0.1 + (i % 7) * 0.1;
+    }
+    std::vector<double> out(vp.size());
+
+    for (DragFunction drag : kDragFunctions) {
+      int rc = retard_v_isa(GetParam(), drag, bc.data(), vp.data(), out.data(), vp.size());
+      if (rc != 0) {
+        GTEST_SKIP() << "instruction set not supported on this CPU";
+      }
+      for (size_t i = 0; i < vp.size(); i++) {
+        double expected = retard(drag, bc[i], vp[i]);
+        if (expected == -1) {
+          ASSERT_EQ(-1, out[i]) << "G" << drag << " at " << vp[i];
+        }
+        else {
+          ASSERT_NEAR(expected, out[i], std::fabs(expected) * 1e-13) << "G" << drag << " at " << vp[i];
+        }
+      }
+    }
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Isa, RetardVTest,
+                           ::testing::Values(DRAG_ISA_GENERIC, DRAG_ISA_AVX2, DRAG_ISA_AVX512));
+
+  TEST(RetardVCheck, DispatchesToBestIsa) {
+    double bc[3] = {0.5, 0.5, 0.5};
+    double vp[3] = {2800, 1100, 400};
+    double out[3];
+    retard_v(G7, bc, vp, out, 3);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_NEAR(retard(G7, bc[i], vp[i]), out[i], out[i] * 1e-13);
+    }
+    EXPECT_EQ(0, retard_v_isa(retard_v_best_isa(), G7, bc, vp, out, 3));
+  }
+
+  TEST(RetardTableCheck, WithinDocumentedError) {
+    for (DragFunction drag : kDragFunctions) {
+      for (double v = -10; v <= 10010; v += 0.0937) {
+        double expected = retard(drag, 0.5, v);
+        double actual = retard_table(drag, 0.5, v);
+        if (expected == -1) {
+          ASSERT_EQ(-1, actual) << "G" << drag << " at " << v;
+        }
+        else {
+          ASSERT_NEAR(expected, actual, std::fabs(expected) * 1e-10) << "G" << drag << " at " << v;
+        }
+      }
+    }
+  }
+} // namespace
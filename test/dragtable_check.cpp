@@ -0,0 +1,131 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+  // G7 expressed as a Cd-vs-Mach curve, sampled the way radar data usually is.
+  class DragTableTest : public ::testing::Test {
+  protected:
+    std::vector<double> mach;
+    std::vector<double> cd;
+    DragTable* table;
+
+    virtual void SetUp() {
+      for (int i = 2; i <= 200; i++) {
+        double m = i*0.025;
+        double v = m*DRAG_TABLE_SPEED_OF_SOUND;
+        mach.push_back(m);
+        cd.push_back(retard(G7, 1, v) / (v*v*DRAG_TABLE_RETARDATION));
+      }
+      table = DragTable_create(mach.data(), cd.data(), mach.size());
+      ASSERT_NE(nullptr, table);
+    }
+
+    virtual void TearDown() {
+      DragTable_free(table);
+    }
+  };
+
+  TEST_F(DragTableTest, ReproducesTheCurveItWasBuiltFrom) {
+    for (size_t i = 0; i < mach.size(); i++) {
+      EXPECT_NEAR(cd[i], DragTable_cd(table, mach[i]), 1e-12);
+    }
+    // Held at the end values outside the curve.
+    EXPECT_DOUBLE_EQ(cd.front(), DragTable_cd(table, 0.01));
+    EXPECT_DOUBLE_EQ(cd.back(), DragTable_cd(table, 9));
+
+    // Away from the G7 segment boundaries the resampled curve tracks the power laws closely.
+    for (double v : {300.0, 500.0, 800.0, 2000.0, 2500.0, 3500.0, 4000.0}) {
+      EXPECT_NEAR(1, DragTable_retard(table, 0.3, v) / retard(G7, 0.3, v), 1e-4) << v << " ft/s";
+    }
+  }
+
+  TEST_F(DragTableTest, SolvesLikeTheDragFunction) {
+    BallisticsInput in = {};
+    in.drag_function = G7;
+    in.drag_coefficient = 0.3;
+    in.vi = 2800;
+    in.sight_height = 1.6;
+    in.zero_angle = 0.1;
+    BallisticsOptions analytic = {};
+    BallisticsOptions custom = {};
+    custom.drag_table = table;
+    // The input's drag function is ignored when a table is given.
+    BallisticsInput other = in;
+    other.drag_function = G1;
+
+    Ballistics* expected = Ballistics_create(1000);
+    Ballistics* actual = Ballistics_create(1000);
+    ASSERT_EQ(1001, Ballistics_solve_into(expected, 1000, &in, &analytic));
+    ASSERT_EQ(1001, Ballistics_solve_into(actual, 1000, &other, &custom));
+    for (int yard = 100; yard <= 1000; yard += 100) {
+      EXPECT_NEAR(Ballistics_get_path(expected, yard), Ballistics_get_path(actual, yard), 1e-3) << yard;
+    }
+    Ballistics_free(expected);
+    Ballistics_free(actual);
+
+    ZeroResult zero_expected, zero_actual;
+    ASSERT_EQ(0, zero_angle_ex(G7, 0.3, 2800, 1.6, 200, 0, &analytic, &zero_expected));
+    ASSERT_EQ(0, zero_angle_ex(G7, 0.3, 2800, 1.6, 200, 0, &custom, &zero_actual));
+    EXPECT_NEAR(zero_expected.angle, zero_actual.angle, 1e-6);
+
+    struct PBR* pbr_expected;
+    struct PBR* pbr_actual;
+    custom.pbr_method = PBR_METHOD_ROOT;
+    analytic.pbr_method = PBR_METHOD_ROOT;
+    ASSERT_EQ(0, PBR_solve_ex(&pbr_expected, G7, 0.3, 2800, 1.6, 6, &analytic));
+    ASSERT_EQ(0, PBR_solve_ex(&pbr_actual, G7, 0.3, 2800, 1.6, 6, &custom));
+    EXPECT_EQ(PBR_get_max_PBR_yards(pbr_expected), PBR_get_max_PBR_yards(pbr_actual));
+    PBR_free(pbr_expected);
+    PBR_free(pbr_actual);
+  }
+
+  TEST_F(DragTableTest, LoadsFromCsv) {
+    char path[] = "/tmp/dragtableXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    FILE* file = fdopen(fd, "w");
+    fprintf(file, "# radar-derived\nmach,cd\n");
+    for (size_t i = 0; i < mach.size(); i++) {
+      fprintf(file, i % 2 ? "%.17g, %.17g\n" : "%.17g\t%.17g\n", mach[i], cd[i]);
+    }
+    fclose(file);
+
+    DragTable* loaded = DragTable_load_csv(path);
+    remove(path);
+    ASSERT_NE(nullptr, loaded);
+    for (double m = 0.05; m < 5; m += 0.0123) {
+      EXPECT_EQ(DragTable_cd(table, m), DragTable_cd(loaded, m));
+    }
+    DragTable_free(loaded);
+    EXPECT_EQ(nullptr, DragTable_load_csv("/nonexistent/drag.csv"));
+  }
+
+  TEST(DragTableInputTest, RejectsInvalidCurves) {
+    const double mach[] = {0.5, 1.0, 1.0, 2.0};
+    const double cd[] = {0.2, 0.4, 0.4, 0.3};
+    const double negative[] = {0.2, -0.4, 0.4, 0.3};
+    EXPECT_EQ(nullptr, DragTable_create(mach, cd, 1));
+    EXPECT_EQ(nullptr, DragTable_create(mach, cd, 4));      // repeated Mach number
+    EXPECT_EQ(nullptr, DragTable_create(mach, negative, 2));
+  }
+}
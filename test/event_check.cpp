@@ -0,0 +1,115 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+namespace {
+  BallisticsInput input() {
+    BallisticsInput in = {};
+    in.drag_function = G7;
+    in.drag_coefficient = 0.25;
+    in.vi = 2700;
+    in.sight_height = 1.6;
+    in.zero_angle = zero_angle(G7, 0.25, 2700, 1.6, 200, 0);
+    return in;
+  }
+
+  // The first range past the search start at which the column reaches value, by scanning every row.
+  double scan(Ballistics* solution, BallisticsColumn column, double s, bool extremum, int first, double value) {
+    int n = Ballistics_get_max_yardage(solution);
+    const double* c = Ballistics_column_ptr(solution, column);
+    const double* range = Ballistics_column_ptr(solution, BALLISTICS_COL_RANGE);
+    int i = first;
+    while (extremum && i + 1 < n && s*c[i] < s*c[i+1]) i++;
+    if (s*c[i] <= s*value) return range[i];
+    for (i++; i < n; i++) {
+      if (s*c[i] <= s*value) {
+        return range[i-1] + (value - c[i-1])/(c[i] - c[i-1])*(range[i] - range[i-1]);
+      }
+    }
+    return -1;
+  }
+
+  struct Query {
+    BallisticsEvent event;
+    double value;
+  };
+
+  const Query queries[] = {
+    {BALLISTICS_EVENT_VELOCITY, 2700}, {BALLISTICS_EVENT_VELOCITY, 2000}, {BALLISTICS_EVENT_VELOCITY, 1125},
+    {BALLISTICS_EVENT_VELOCITY, 100},
+    {BALLISTICS_EVENT_PATH, 0}, {BALLISTICS_EVENT_PATH, -60}, {BALLISTICS_EVENT_PATH, -1000},
+    {BALLISTICS_EVENT_PATH, 50}, {BALLISTICS_EVENT_PATH, -1e6},
+    {BALLISTICS_EVENT_MOA, 0}, {BALLISTICS_EVENT_MOA, 10}, {BALLISTICS_EVENT_MOA, 60}, {BALLISTICS_EVENT_MOA, 1e4},
+    {BALLISTICS_EVENT_TIME, 0}, {BALLISTICS_EVENT_TIME, 0.5}, {BALLISTICS_EVENT_TIME, 1.2},
+    {BALLISTICS_EVENT_TIME, 100},
+  };
+
+  TEST(EventCheck, FindMatchesAScan) {
+    BallisticsInput in = input();
+    Ballistics* solution = Ballistics_create(2000);
+    ASSERT_EQ(2001, Ballistics_solve_into(solution, 2000, &in, NULL));
+
+    for (const Query& q : queries) {
+      double expected;
+      switch (q.event) {
+        case BALLISTICS_EVENT_VELOCITY: expected = scan(solution, BALLISTICS_COL_V, 1, false, 0, q.value); break;
+        case BALLISTICS_EVENT_PATH: expected = scan(solution, BALLISTICS_COL_PATH, 1, true, 0, q.value); break;
+        case BALLISTICS_EVENT_MOA: expected = scan(solution, BALLISTICS_COL_MOA, -1, true, 1, q.value); break;
+        default: expected = scan(solution, BALLISTICS_COL_TIME, -1, false, 0, q.value); break;
+      }
+      EXPECT_EQ(expected, Ballistics_find_event(solution, q.event, q.value)) << q.event << " " << q.value;
+    }
+
+    // Transonic, 60 in of drop and 1.2 s of flight all fall between 500 and 2000 yards, within a yard of the
+    // rows that bracket them.
+    double transonic = Ballistics_find_event(solution, BALLISTICS_EVENT_VELOCITY, 1125);
+    ASSERT_GT(transonic, 500);
+    EXPECT_GT(Ballistics_get_v_fps(solution, (int)transonic), 1125);
+    EXPECT_LT(Ballistics_get_v_fps(solution, (int)transonic + 2), 1125);
+    double drop = Ballistics_find_event(solution, BALLISTICS_EVENT_PATH, -60);
+    EXPECT_GT(Ballistics_get_path(solution, (int)drop - 1), -60);
+    EXPECT_LT(Ballistics_get_path(solution, (int)drop + 1), -60);
+    EXPECT_GT(Ballistics_find_event(solution, BALLISTICS_EVENT_TIME, 1.2), 500);
+
+    EXPECT_EQ(-1, Ballistics_find_event(solution, (BallisticsEvent)99, 0));
+    Ballistics_free(solution);
+  }
+
+  class EventTest : public ::testing::TestWithParam<BallisticsEngine> {};
+
+  TEST_P(EventTest, SolveStopsAtTheEventFindWouldFind) {
+    BallisticsInput in = input();
+    BallisticsOptions options = {};
+    options.engine = GetParam();
+    Ballistics* solution = Ballistics_create(2000);
+    ASSERT_EQ(2001, Ballistics_solve_steps(solution, 0, 1, 2000, &in, &options));
+
+    for (const Query& q : queries) {
+      EXPECT_EQ(Ballistics_find_event(solution, q.event, q.value),
+                Ballistics_solve_event(q.event, q.value, 2000, &in, &options)) << q.event << " " << q.value;
+    }
+    // Still climbing at the last yard, the path's maximum is there.
+    ASSERT_EQ(51, Ballistics_solve_steps(solution, 0, 1, 50, &in, &options));
+    EXPECT_EQ(50, Ballistics_find_event(solution, BALLISTICS_EVENT_PATH, 10));
+    EXPECT_EQ(50, Ballistics_solve_event(BALLISTICS_EVENT_PATH, 10, 50, &in, &options));
+    EXPECT_EQ(-1, Ballistics_solve_event(BALLISTICS_EVENT_PATH, -1, 50, &in, &options));
+    Ballistics_free(solution);
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Engines, EventTest, ::testing::Values(BALLISTICS_ENGINE_EULER, BALLISTICS_ENGINE_RK45));
+}
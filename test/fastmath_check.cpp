@@ -0,0 +1,132 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+#include "ballistics/solver.hpp"
+
+#include <cmath>
+#include <string>
+
+namespace {
+  const DragFunction drag_functions[] = {G1, G2, G5, G6, G7, G8};
+  const char* const drag_names[] = {"G1", "G2", "G5", "G6", "G7", "G8"};
+
+  // The bound documented in fastmath.h, over the exponents the drag functions use and well beyond.
+  TEST(FastMathTest, PowWithinDocumentedBound) {
+    const double ys[] = {-7.5, -2.5, -1, -0.3, 0.5, 1, 1.55636358091189, 2, 3.1, 6.6, 12.25};
+    for (double y : ys) {
+      for (double x = 1e-3; x < 2e4; x *= 1.0007) {
+        double expected = pow(x, y);
+        double bound = (2 + std::fabs(y)*(1 + std::fabs(std::log2(x))))*2*DBL_EPSILON;
+        EXPECT_NEAR(expected, fast_pow(x, y), expected*bound) << x << "^" << y;
+      }
+    }
+  }
+
+  TEST(FastMathTest, PowFallsBackOutsideItsDomain) {
+    const double xs[] = {0, -0.0, -2, 1e-320, INFINITY, NAN, 1e300};
+    for (double x : xs) {
+      EXPECT_EQ(std::isnan(pow(x, 1.5)), std::isnan(fast_pow(x, 1.5))) << x;
+      if (!std::isnan(pow(x, 1.5))) {
+        EXPECT_EQ(pow(x, 1.5), fast_pow(x, 1.5)) << x;
+      }
+      if (!std::isnan(pow(x, 3.0))) {
+        EXPECT_EQ(pow(x, 3.0), fast_pow(x, 3.0)) << x;
+      }
+    }
+    EXPECT_EQ(pow(2.0, 2000.0), fast_pow(2.0, 2000.0));
+    EXPECT_DOUBLE_EQ(1, fast_pow(1, 3.7));
+    EXPECT_DOUBLE_EQ(1024, fast_pow(2, 10));
+    EXPECT_DOUBLE_EQ(0.5, fast_pow(4, -0.5));
+  }
+
+  TEST(FastMathTest, RetardFastMatchesRetard) {
+    for (DragFunction df : drag_functions) {
+      for (double vp = 0.25; vp < 10000; vp += 0.25) {
+        double expected = retard(df, 0.5, vp);
+        EXPECT_NEAR(expected, retard_fast(df, 0.5, vp), expected*1e-13) << df << " " << vp;
+        EXPECT_EQ(retard_fast(df, 0.5, vp), (ballistics::retard<double, ballistics::FastMath>(df, 0.5, vp))) << vp;
+      }
+      EXPECT_EQ(-1, retard_fast(df, 0.5, 0));
+      EXPECT_EQ(-1, retard_fast(df, 0.5, 10000));
+    }
+    EXPECT_EQ(-1, retard_fast(G3, 0.5, 2000));
+  }
+
+  // The trajectory error the fast backend costs at 1000 yards, for every drag function and both engines,
+  // reported as test properties.  The Euler engine's fixed steps keep the difference at rounding level; the
+  // adaptive engine can accept or reject a step differently, which moves it by a thousandth of an inch or less.
+  TEST(FastMathTest, TrajectoryErrorAt1000Yards) {
+    const BallisticsEngine engines[] = {BALLISTICS_ENGINE_EULER, BALLISTICS_ENGINE_RK45};
+    const char* const engine_names[] = {"euler", "rk45"};
+    for (int e = 0; e < 2; e++) {
+      for (int k = 0; k < 6; k++) {
+        BallisticsInput in = {drag_functions[k], 0.4, 2800, 1.5, 0, 0, 10, 90};
+        in.zero_angle = zero_angle(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0);
+        BallisticsOptions exact_options = {DRAG_MODE_ANALYTIC, engines[e]};
+        BallisticsOptions fast_options = exact_options;
+        fast_options.math = BALLISTICS_MATH_FAST;
+
+        Ballistics* exact;
+        Ballistics* fast;
+        ASSERT_LT(1000, Ballistics_solve_ex(&exact, &in, &exact_options));
+        ASSERT_LT(1000, Ballistics_solve_ex(&fast, &in, &fast_options));
+
+        double path = std::fabs(Ballistics_get_path(exact, 1000) - Ballistics_get_path(fast, 1000));
+        double windage = std::fabs(Ballistics_get_windage(exact, 1000) - Ballistics_get_windage(fast, 1000));
+        double v = std::fabs(Ballistics_get_v_fps(exact, 1000) - Ballistics_get_v_fps(fast, 1000));
+        double time = std::fabs(Ballistics_get_time(exact, 1000) - Ballistics_get_time(fast, 1000));
+        std::string name = std::string(engine_names[e]) + "_" + drag_names[k];
+        RecordProperty(name + "_path_inches", std::to_string(path));
+        RecordProperty(name + "_windage_inches", std::to_string(windage));
+        RecordProperty(name + "_v_fps", std::to_string(v));
+        RecordProperty(name + "_time_s", std::to_string(time));
+
+        double scale = engines[e] == BALLISTICS_ENGINE_EULER ? 1 : 1e6;
+        EXPECT_LT(path, 1e-9*scale) << name;
+        EXPECT_LT(windage, 1e-9*scale) << name;
+        EXPECT_LT(v, 1e-8*scale) << name;
+        EXPECT_LT(time, 1e-12*scale) << name;
+
+        Ballistics_free(exact);
+        Ballistics_free(fast);
+      }
+    }
+  }
+
+  TEST(FastMathTest, ZeroAndPbrAgreeWithExact) {
+    BallisticsOptions exact_options = {};
+    BallisticsOptions fast_options = {};
+    fast_options.math = BALLISTICS_MATH_FAST;
+    for (DragFunction df : drag_functions) {
+      ZeroResult exact_zero, fast_zero;
+      ASSERT_EQ(0, zero_angle_ex(df, 0.4, 2800, 1.5, 200, 0, &exact_options, &exact_zero));
+      ASSERT_EQ(0, zero_angle_ex(df, 0.4, 2800, 1.5, 200, 0, &fast_options, &fast_zero));
+      EXPECT_NEAR(exact_zero.angle, fast_zero.angle, 1e-9) << df;
+
+      struct PBR* exact_pbr;
+      struct PBR* fast_pbr;
+      ASSERT_EQ(0, PBR_solve_ex(&exact_pbr, df, 0.4, 2800, 1.5, 6, &exact_options));
+      ASSERT_EQ(0, PBR_solve_ex(&fast_pbr, df, 0.4, 2800, 1.5, 6, &fast_options));
+      EXPECT_EQ(PBR_get_near_zero_yards(exact_pbr), PBR_get_near_zero_yards(fast_pbr)) << df;
+      EXPECT_EQ(PBR_get_far_zero_yards(exact_pbr), PBR_get_far_zero_yards(fast_pbr)) << df;
+      EXPECT_EQ(PBR_get_max_PBR_yards(exact_pbr), PBR_get_max_PBR_yards(fast_pbr)) << df;
+      PBR_free(exact_pbr);
+      PBR_free(fast_pbr);
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <vector>
+
+namespace {
+  const double ranges[] = {100, 300, 600, 1000};
+
+  BallisticsMonteCarlo study() {
+    BallisticsMonteCarlo mc = {};
+    mc.input.drag_function = G7;
+    mc.input.drag_coefficient = 0.3;
+    mc.input.vi = 2800;
+    mc.input.sight_height = 1.6;
+    mc.input.zero_angle = zero_angle(G7, 0.3, 2800, 1.6, 100, 0);
+    mc.input.wind_speed = 10;
+    mc.input.wind_angle = 90;
+    mc.ranges = ranges;
+    mc.range_count = 4;
+    mc.target_width = 10;
+    mc.target_height = 10;
+    mc.samples = 500;
+    mc.seed = 42;
+    return mc;
+  }
+
+  unsigned long total(const unsigned long* bins, const unsigned long* outside) {
+    unsigned long n = outside[0] + outside[1];
+    for (int b = 0; b < BALLISTICS_MC_BINS; b++) n += bins[b];
+    return n;
+  }
+
+  TEST(MonteCarloTest, WithoutVariationEveryShotHitsTheAimPoint) {
+    BallisticsMonteCarlo mc = study();
+    mc.samples = 100;
+    BallisticsMonteCarloRange out[4];
+    ASSERT_EQ(0, Ballistics_monte_carlo(&mc, NULL, out));
+    for (int r = 0; r < 4; r++) {
+      EXPECT_EQ(ranges[r], out[r].range);
+      EXPECT_EQ(100u, out[r].reached);
+      EXPECT_EQ(100u, out[r].hits);
+      EXPECT_EQ(1, out[r].p_hit);
+      EXPECT_NEAR(0, out[r].mean_vertical, 1e-9);
+      EXPECT_NEAR(0, out[r].mean_horizontal, 1e-9);
+      EXPECT_NEAR(0, out[r].sd_vertical, 1e-9);
+      EXPECT_EQ(100u, out[r].vertical[BALLISTICS_MC_BINS/2]);
+    }
+  }
+
+  TEST(MonteCarloTest, ResultsDoNotDependOnThreads) {
+    BallisticsMonteCarlo mc = study();
+    mc.vi_sd = 15;
+    mc.drag_coefficient_sd = 0.02;
+    mc.wind_speed_sd = 3;
+    mc.wind_angle_sd = 20;
+    mc.range_sd = 0.03;
+    BallisticsMonteCarloRange one[4], many[4];
+    ASSERT_EQ(0, Ballistics_monte_carlo(&mc, NULL, one));
+    mc.threads = 4;
+    ASSERT_EQ(0, Ballistics_monte_carlo(&mc, NULL, many));
+    for (int r = 0; r < 4; r++) {
+      EXPECT_EQ(one[r].hits, many[r].hits);
+      EXPECT_EQ(one[r].reached, many[r].reached);
+      EXPECT_NEAR(one[r].mean_vertical, many[r].mean_vertical, 1e-9);
+      EXPECT_NEAR(one[r].sd_vertical, many[r].sd_vertical, 1e-9);
+      EXPECT_NEAR(one[r].sd_horizontal, many[r].sd_horizontal, 1e-9);
+      for (int b = 0; b < BALLISTICS_MC_BINS; b++) {
+        EXPECT_EQ(one[r].vertical[b], many[r].vertical[b]);
+        EXPECT_EQ(one[r].horizontal[b], many[r].horizontal[b]);
+      }
+      EXPECT_EQ(mc.samples, total(many[r].vertical, many[r].vertical_outside));
+      EXPECT_EQ(mc.samples, total(many[r].horizontal, many[r].horizontal_outside));
+    }
+
+    mc.seed = 43;
+    ASSERT_EQ(0, Ballistics_monte_carlo(&mc, NULL, many));
+    EXPECT_NE(one[3].mean_vertical, many[3].mean_vertical);
+  }
+
+  // With muzzle velocity the only variation, the vertical spread is about the path's sensitivity to muzzle
+  // velocity times its standard deviation, and hits fall as the spread outgrows the target.
+  TEST(MonteCarloTest, VelocitySpreadMatchesSensitivity) {
+    BallisticsMonteCarlo mc = study();
+    mc.input.wind_speed = 0;
+    mc.vi_sd = 20;
+    mc.samples = 2000;
+    mc.threads = 4;
+    BallisticsMonteCarloRange out[4];
+    ASSERT_EQ(0, Ballistics_monte_carlo(&mc, NULL, out));
+
+    BallisticsInput fast = mc.input, slow = mc.input;
+    fast.vi += 10;
+    slow.vi -= 10;
+    Ballistics* a = Ballistics_create(1000);
+    Ballistics* b = Ballistics_create(1000);
+    Ballistics_solve_ranges(a, ranges, 4, &fast, NULL);
+    Ballistics_solve_ranges(b, ranges, 4, &slow, NULL);
+    for (int r = 1; r < 4; r++) {
+      double sensitivity = (Ballistics_get_path(a, r) - Ballistics_get_path(b, r)) / 20;
+      EXPECT_NEAR(fabs(sensitivity)*20, out[r].sd_vertical, 0.05*fabs(sensitivity)*20) << ranges[r];
+      EXPECT_EQ(0, out[r].sd_horizontal) << ranges[r];
+    }
+    EXPECT_EQ(1, out[0].p_hit);
+    EXPECT_LT(out[3].p_hit, out[2].p_hit);
+    Ballistics_free(a);
+    Ballistics_free(b);
+  }
+
+  TEST(MonteCarloTest, RejectsMalformedStudies) {
+    BallisticsMonteCarlo mc = study();
+    BallisticsMonteCarloRange out[4];
+    const double unordered[] = {300, 100};
+    mc.ranges = unordered;
+    mc.range_count = 2;
+    EXPECT_EQ(-1, Ballistics_monte_carlo(&mc, NULL, out));
+    mc = study();
+    mc.samples = 0;
+    EXPECT_EQ(-1, Ballistics_monte_carlo(&mc, NULL, out));
+  }
+}
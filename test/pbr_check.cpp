@@ -15,7 +15,9 @@
  */
 
 #include "gtest/gtest.h"
-#include "ballistics/pbr.h"
+#include "ballistics/ballistics.h"
+
+#include <cstdlib>
 
 namespace {
   class PBRTest : public ::testing::Test {
@@ -38,4 +40,84 @@ namespace {
     EXPECT_EQ(238, PBR_get_max_PBR_yards(pbr));
     EXPECT_DOUBLE_EQ(1.89, PBR_get_sight_in_at_100yards(pbr) / 100.0);
   }
-} // namespace
\ No newline at end of file
+
+  struct Load {
+    DragFunction drag_function;
+    double drag_coefficient;
+    double vi;
+    double sight_height;
+    double vital_size;
+  };
+
+  class PBRMethodTest : public ::testing::TestWithParam<Load> {
+  };
+
+  TEST_P(PBRMethodTest, RootFindingMatchesStepHalvingWithinAYard) {
+    Load l = GetParam();
+    struct PBR* halving;
+    struct PBR* root;
+    BallisticsOptions options = {};
+    options.pbr_method = PBR_METHOD_ROOT;
+
+    ASSERT_EQ(0, PBR_solve(&halving, l.drag_function, l.drag_coefficient, l.vi, l.sight_height, l.vital_size));
+    ASSERT_EQ(0, PBR_solve_ex(&root, l.drag_function, l.drag_coefficient, l.vi, l.sight_height, l.vital_size,
+                              &options));
+
+    EXPECT_LE(std::abs(PBR_get_near_zero_yards(halving) - PBR_get_near_zero_yards(root)), 1);
+    EXPECT_LE(std::abs(PBR_get_far_zero_yards(halving) - PBR_get_far_zero_yards(root)), 1);
+    EXPECT_LE(std::abs(PBR_get_min_PBR_yards(halving) - PBR_get_min_PBR_yards(root)), 1);
+    EXPECT_LE(std::abs(PBR_get_max_PBR_yards(halving) - PBR_get_max_PBR_yards(root)), 1);
+    EXPECT_LE(std::abs(PBR_get_sight_in_at_100yards(halving) - PBR_get_sight_in_at_100yards(root)), 5);
+
+    PBR_free(halving);
+    PBR_free(root);
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Loads, PBRMethodTest, ::testing::Values(
+      Load{G1, 0.48, 2800, 1.5, 4},
+      Load{G1, 0.25, 1200, 1.5, 8},
+      Load{G1, 0.7, 3200, 2.0, 10},
+      Load{G7, 0.2, 2600, 1.5, 4},
+      Load{G5, 0.3, 2100, 1.5, 6},
+      Load{G1, 0.5, 2800, 1.6, 3}));
+
+  long steps;
+
+  void count_steps(const BallisticsStats* stats, void*) {
+    steps += stats->steps;
+  }
+
+  TEST(PBRManyTest, MatchesSeparateSolvesForLessWork) {
+    const double sizes[] = {4, 10, 6, 8};
+    const size_t n = sizeof(sizes)/sizeof(sizes[0]);
+    struct PBR* many[n];
+    BallisticsOptions options = {};
+    options.pbr_method = PBR_METHOD_ROOT;
+
+    Ballistics_set_stats_callback(count_steps, NULL);
+    steps = 0;
+    ASSERT_EQ(0, PBR_solve_many(G1, 0.48, 2800, 1.5, sizes, n, many));
+    long many_steps = steps;
+
+    steps = 0;
+    for (size_t i = 0; i < n; i++) {
+      struct PBR* one;
+      ASSERT_EQ(0, PBR_solve_ex(&one, G1, 0.48, 2800, 1.5, sizes[i], &options));
+      EXPECT_LE(std::abs(PBR_get_near_zero_yards(one) - PBR_get_near_zero_yards(many[i])), 1);
+      EXPECT_LE(std::abs(PBR_get_far_zero_yards(one) - PBR_get_far_zero_yards(many[i])), 1);
+      EXPECT_LE(std::abs(PBR_get_min_PBR_yards(one) - PBR_get_min_PBR_yards(many[i])), 1);
+      EXPECT_LE(std::abs(PBR_get_max_PBR_yards(one) - PBR_get_max_PBR_yards(many[i])), 1);
+      PBR_free(one);
+      PBR_free(many[i]);
+    }
+    Ballistics_set_stats_callback(NULL, NULL);
+
+    // The cost documented in pbr.h: about twice one solve, and a little over half of solving each size.
+#ifdef BALLISTICS_INSTRUMENTATION
+    EXPECT_LT(many_steps, steps*6/10);
+    EXPECT_LT(many_steps, (long)(steps/n*5/2));
+#else
+    (void)many_steps;
+#endif
+  }
+} // namespace
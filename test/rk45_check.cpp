@@ -0,0 +1,87 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <cmath>
+
+namespace {
+  struct Load {
+    DragFunction drag_function;
+    double drag_coefficient;
+    double vi;
+  };
+
+  class Rk45Test : public ::testing::TestWithParam<Load> {
+  protected:
+    BallisticsInput in;
+
+    virtual void SetUp() {
+      Load load = GetParam();
+      in = {load.drag_function, load.drag_coefficient, load.vi, 1.5, 0, 0, 10, 90};
+      in.zero_angle = zero_angle(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0);
+    }
+
+    // Largest path difference from the reference over the first 1000 yards, in inches.
+    static double pathError(Ballistics* reference, Ballistics* solution) {
+      double worst = 0;
+      for (int yard = 1; yard <= 1000; yard++) {
+        worst = std::fmax(worst, std::fabs(Ballistics_get_path(reference, yard) - Ballistics_get_path(solution, yard)));
+      }
+      return worst;
+    }
+  };
+
+  // Compares both engines against a tightly converged RK45 reference.  The adaptive engine must be at least as
+  // accurate while evaluating retard() an order of magnitude less often.
+  TEST_P(Rk45Test, FewerEvaluationsAtBetterAccuracy) {
+    BallisticsOptions reference_options = {DRAG_MODE_ANALYTIC, BALLISTICS_ENGINE_RK45, 1e-12};
+    BallisticsOptions rk45_options = {DRAG_MODE_ANALYTIC, BALLISTICS_ENGINE_RK45, 0};
+    BallisticsOptions euler_options = {DRAG_MODE_ANALYTIC, BALLISTICS_ENGINE_EULER, 0};
+
+    Ballistics* reference;
+    Ballistics* rk45;
+    Ballistics* euler;
+    Ballistics_solve_ex(&reference, &in, &reference_options);
+    ASSERT_LT(1000, Ballistics_solve_ex(&rk45, &in, &rk45_options));
+    ASSERT_LT(1000, Ballistics_solve_ex(&euler, &in, &euler_options));
+
+    double rk45_error = pathError(reference, rk45);
+    double euler_error = pathError(reference, euler);
+    long rk45_evaluations = Ballistics_get_drag_evaluations(rk45);
+    long euler_evaluations = Ballistics_get_drag_evaluations(euler);
+    RecordProperty("rk45_error_inches", std::to_string(rk45_error));
+    RecordProperty("euler_error_inches", std::to_string(euler_error));
+    RecordProperty("rk45_evaluations", std::to_string(rk45_evaluations));
+    RecordProperty("euler_evaluations", std::to_string(euler_evaluations));
+
+    EXPECT_LE(rk45_error, euler_error);
+    EXPECT_LT(rk45_error, 0.01);
+    EXPECT_LE(rk45_evaluations * 10, euler_evaluations);
+
+    // Samples are taken at exact yards rather than at the step that crosses them.
+    EXPECT_DOUBLE_EQ(500, Ballistics_get_range(rk45, 500));
+
+    Ballistics_free(reference);
+    Ballistics_free(rk45);
+    Ballistics_free(euler);
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Loads, Rk45Test, ::testing::Values(
+      Load{G1, 0.5, 1200}, Load{G1, 0.465, 2750}, Load{G7, 0.3, 2900}, Load{G2, 0.4, 2000}, Load{G5, 0.35, 3100},
+      Load{G6, 0.3, 2600}, Load{G8, 0.45, 2400}));
+} // namespace
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/solver.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+  const DragFunction drag_functions[] = {G1, G2, G5, G6, G7, G8};
+
+  TEST(SolverTest, DoubleIsTheStandardEngine) {
+    for (int k = 0; k < 4; k++) {
+      BallisticsInput in = {G1, 0.3 + 0.1*k, 1500 + 700.0*k, 1.5, k*10.0 - 5, 0.1*k, 10, 45 + 20.0*k};
+      Ballistics* expected = Ballistics_create(1000);
+      int n = Ballistics_solve_into(expected, 1000, &in, NULL);
+      std::vector<ballistics::Row<double>> rows(1001);
+      ASSERT_EQ(n, ballistics::Solver<double>(in).solve(rows.data(), 1001));
+      for (int i = 0; i < n; i++) {
+        EXPECT_EQ(Ballistics_get_path(expected, i), rows[i].path) << i;
+        EXPECT_EQ(Ballistics_get_time(expected, i), rows[i].time) << i;
+        EXPECT_EQ(Ballistics_get_windage(expected, i), rows[i].windage) << i;
+        EXPECT_EQ(Ballistics_get_v_fps(expected, i), rows[i].v) << i;
+      }
+      Ballistics_free(expected);
+    }
+  }
+
+  TEST(SolverTest, FloatRetardationMatchesDouble) {
+    for (DragFunction df : drag_functions) {
+      for (double vp = 1; vp < 10000; vp += 0.75) {
+        double expected = retard(df, 0.5, vp);
+        EXPECT_NEAR(expected, ballistics::retard<float>(df, 0.5f, (float)vp), expected*1e-5) << df << " " << vp;
+      }
+    }
+    EXPECT_EQ(-1, ballistics::retard<float>(G3, 0.5f, 2000.0f));
+  }
+
+  TEST(SolverTest, DragModelsMatchRetard) {
+    for (double vp = -1; vp < 10001; vp += 0.25) {
+      EXPECT_EQ(retard(G1, 0.5, vp), ballistics::DragModel<G1>::retard(0.5, vp)) << vp;
+      EXPECT_EQ(retard(G2, 0.5, vp), ballistics::DragModel<G2>::retard(0.5, vp)) << vp;
+      EXPECT_EQ(retard(G5, 0.5, vp), ballistics::DragModel<G5>::retard(0.5, vp)) << vp;
+      EXPECT_EQ(retard(G6, 0.5, vp), ballistics::DragModel<G6>::retard(0.5, vp)) << vp;
+      EXPECT_EQ(retard(G7, 0.5, vp), ballistics::DragModel<G7>::retard(0.5, vp)) << vp;
+      EXPECT_EQ(retard(G8, 0.5, vp), ballistics::DragModel<G8>::retard(0.5, vp)) << vp;
+    }
+    // Exactly on a threshold, the slower segment applies.
+    EXPECT_EQ(retard(G1, 0.5, 4230.0), ballistics::DragModel<G1>::retard(0.5, 4230.0));
+    EXPECT_EQ(retard(G7, 0.5, 1470.0), ballistics::DragModel<G7>::retard(0.5, 1470.0));
+  }
+
+  TEST(SolverTest, SpecializedSolveMatchesDispatch) {
+    BallisticsInput in = {G7, 0.3, 2900, 1.6, 0, 0.05, 10, 90};
+    std::vector<ballistics::Row<float>> dispatched(1001);
+    std::vector<ballistics::Row<float>> specialized(1001);
+    int n = ballistics::Solver<float>(in).solve(dispatched.data(), 1001);
+    ASSERT_EQ(n, ballistics::solve<G7>(in, specialized.data(), 1001));
+    for (int i = 0; i < n; i++) {
+      EXPECT_EQ(dispatched[i].path, specialized[i].path) << i;
+      EXPECT_EQ(dispatched[i].v, specialized[i].v) << i;
+    }
+  }
+
+  // The error budget documented in solver.hpp: the float path against the double one, out to 1000 yards, over
+  // every drag function with coefficients and muzzle velocities across their useful range.  Paths are compared
+  // at the float row's range, since each row is taken at the first step past its yard and float can land on a
+  // neighbouring step.
+  TEST(SolverTest, FloatStaysWithinItsErrorBudget) {
+    for (DragFunction df : drag_functions) {
+      for (double vi = 1000; vi <= 4500; vi += 250) {
+        for (double bc : {0.2, 0.5, 0.9}) {
+          for (double shooting_angle : {0.0, 30.0}) {
+            BallisticsInput in = {df, bc, vi, 1.6, shooting_angle, 0.05, 10, 90};
+            std::vector<ballistics::Row<double>> reference(1001);
+            std::vector<ballistics::Row<float>> rows(1001);
+            int n = ballistics::Solver<double>(in).solve(reference.data(), 1001);
+            ASSERT_EQ(n, ballistics::Solver<float>(in).solve(rows.data(), 1001));
+
+            for (int i = 1; i + 1 < n; i++) {
+              const ballistics::Row<float>& row = rows[i];
+              const ballistics::Row<double>& a = reference[i];
+              const ballistics::Row<double>& b = reference[i + 1];
+              double path = a.path + (row.range - a.range)*(b.path - a.path)/(b.range - a.range);
+              ASSERT_NEAR(a.range, row.range, 0.17) << df << " " << vi << " " << bc << " " << i;
+              ASSERT_NEAR(path, row.path, 0.5) << df << " " << vi << " " << bc << " " << i;
+              ASSERT_NEAR(a.v, row.v, 0.4) << df << " " << vi << " " << bc << " " << i;
+              ASSERT_NEAR(a.time, row.time, 1.3e-3) << df << " " << vi << " " << bc << " " << i;
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <vector>
+
+namespace {
+#ifndef BALLISTICS_INSTRUMENTATION
+#define REQUIRE_INSTRUMENTATION() GTEST_SKIP() << "built without BALLISTICS_INSTRUMENTATION"
+#else
+#define REQUIRE_INSTRUMENTATION()
+#endif
+
+  BallisticsInput input(double shooting_angle, double zero_angle) {
+    BallisticsInput in = {};
+    in.drag_function = G1;
+    in.drag_coefficient = 0.5;
+    in.vi = 2800;
+    in.sight_height = 1.6;
+    in.shooting_angle = shooting_angle;
+    in.zero_angle = zero_angle;
+    return in;
+  }
+
+  TEST(StatsTest, SolveReportsStepsAndRangeStop) {
+    REQUIRE_INSTRUMENTATION();
+    BallisticsStats stats = {};
+    BallisticsOptions options = {};
+    options.stats = &stats;
+    BallisticsInput in = input(0, 0.1);
+
+    Ballistics* solution = Ballistics_create(500);
+    int rows = Ballistics_solve_into(solution, 500, &in, &options);
+    EXPECT_EQ(BALLISTICS_CALL_SOLVE, stats.call);
+    EXPECT_EQ(BALLISTICS_STOP_RANGE, stats.stop);
+    EXPECT_EQ(rows, stats.status);
+    EXPECT_EQ(1, stats.iterations);
+    EXPECT_EQ(Ballistics_get_drag_evaluations(solution), stats.steps);
+    EXPECT_EQ(stats.steps, stats.retard_calls);
+    EXPECT_GT(stats.wall_seconds, 0);
+
+    options.engine = BALLISTICS_ENGINE_RK45;
+    Ballistics_solve_into(solution, 500, &in, &options);
+    EXPECT_EQ(BALLISTICS_STOP_RANGE, stats.stop);
+    EXPECT_EQ(Ballistics_get_drag_evaluations(solution), stats.retard_calls);
+    EXPECT_LT(stats.steps, stats.retard_calls);
+    Ballistics_free(solution);
+  }
+
+  TEST(StatsTest, SteepShotStopsOnVerticalVelocity) {
+    REQUIRE_INSTRUMENTATION();
+    BallisticsStats stats = {};
+    BallisticsOptions options = {};
+    options.stats = &stats;
+    BallisticsInput in = input(60, 20);
+
+    Ballistics* solution = Ballistics_create(BALLISTICS_COMPUTATION_MAX_YARDS);
+    Ballistics_solve_into(solution, BALLISTICS_COMPUTATION_MAX_YARDS, &in, &options);
+    EXPECT_EQ(BALLISTICS_STOP_STEEP, stats.stop);
+    Ballistics_free(solution);
+  }
+
+  TEST(StatsTest, ZeroAngleReportsIterationsAndCutoff) {
+    REQUIRE_INSTRUMENTATION();
+    BallisticsStats stats = {};
+    BallisticsOptions options = {};
+    options.stats = &stats;
+    ZeroResult result;
+
+    ASSERT_EQ(0, zero_angle_ex(G1, 0.5, 2800, 1.6, 200, 0, &options, &result));
+    EXPECT_EQ(BALLISTICS_CALL_ZERO_ANGLE, stats.call);
+    EXPECT_EQ(BALLISTICS_STOP_CONVERGED, stats.stop);
+    EXPECT_EQ(result.iterations, stats.iterations);
+    EXPECT_GT(stats.steps, 0);
+
+    EXPECT_EQ(-1, zero_angle_ex(G1, 0.5, 2800, 1.6, 100, 1e6, &options, &result));
+    EXPECT_EQ(BALLISTICS_STOP_ANGLE_LIMIT, stats.stop);
+    EXPECT_EQ(-1, stats.status);
+  }
+
+  void collect(const BallisticsStats* stats, void* context) {
+    static_cast<std::vector<BallisticsStats>*>(context)->push_back(*stats);
+  }
+
+  TEST(StatsTest, CallbackSeesEveryCall) {
+    REQUIRE_INSTRUMENTATION();
+    std::vector<BallisticsStats> seen;
+    Ballistics_set_stats_callback(collect, &seen);
+
+    double angle = zero_angle(G1, 0.5, 2800, 1.6, 100, 0);
+    Ballistics* solution;
+    Ballistics_solve(&solution, G1, 0.5, 2800, 1.6, 0, angle, 0, 0);
+    Ballistics_free(solution);
+    struct PBR* pbr;
+    int status = PBR_solve(&pbr, G1, 0.5, 2800, 1.6, 6);
+    if (status == 0) PBR_free(pbr);
+
+    Ballistics_set_stats_callback(NULL, NULL);
+    zero_angle(G1, 0.5, 2800, 1.6, 100, 0);
+
+    ASSERT_EQ(3u, seen.size());
+    EXPECT_EQ(BALLISTICS_CALL_ZERO_ANGLE, seen[0].call);
+    EXPECT_EQ(BALLISTICS_CALL_SOLVE, seen[1].call);
+    EXPECT_EQ(BALLISTICS_CALL_PBR, seen[2].call);
+    EXPECT_EQ(status, seen[2].status);
+    EXPECT_GT(seen[2].iterations, 1);
+    EXPECT_GT(seen[2].retard_calls, seen[1].retard_calls);
+  }
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <cmath>
+
+namespace {
+  BallisticsInput input(DragFunction drag_function, double drag_coefficient) {
+    BallisticsInput in = {};
+    in.drag_function = drag_function;
+    in.drag_coefficient = drag_coefficient;
+    in.vi = 2800;
+    in.sight_height = 1.6;
+    in.zero_angle = zero_angle(drag_function, drag_coefficient, 2800, 1.6, 100, 0);
+    in.wind_speed = 10;
+    in.wind_angle = 60;
+    return in;
+  }
+
+  class TrajectoryTest : public ::testing::TestWithParam<BallisticsEngine> {
+  protected:
+    // Checks every yard of the trajectory against the table solved at every yard.
+    void expect_fits(const BallisticsInput& in, const BallisticsOptions& options, double path_tolerance,
+                     double velocity_tolerance) {
+      Ballistics* table = Ballistics_create(1000);
+      ASSERT_EQ(1001, Ballistics_solve_steps(table, 0, 1, 1000, &in, &options));
+      Trajectory* trajectory = Trajectory_solve(1000, &in, &options, path_tolerance, velocity_tolerance);
+      ASSERT_NE(nullptr, trajectory);
+      EXPECT_EQ(1000, Trajectory_get_max_range(trajectory));
+      EXPECT_EQ(Ballistics_get_time(table, 1000), Trajectory_get_max_time(trajectory));
+
+      double row[BALLISTICS_COLUMNS];
+      for (int yard = 0; yard <= 1000; yard++) {
+        ASSERT_EQ(0, Trajectory_at_range(trajectory, yard, row));
+        EXPECT_NEAR(yard, row[BALLISTICS_COL_RANGE], 1e-12);
+        EXPECT_NEAR(Ballistics_get_path(table, yard), row[BALLISTICS_COL_PATH], path_tolerance) << yard;
+        EXPECT_NEAR(Ballistics_get_windage(table, yard), row[BALLISTICS_COL_WINDAGE], path_tolerance) << yard;
+        EXPECT_NEAR(Ballistics_get_v_fps(table, yard), row[BALLISTICS_COL_V], velocity_tolerance) << yard;
+        EXPECT_NEAR(Ballistics_get_time(table, yard), row[BALLISTICS_COL_TIME], path_tolerance/12/in.vi) << yard;
+      }
+      Trajectory_free(trajectory);
+      Ballistics_free(table);
+    }
+  };
+
+  TEST_P(TrajectoryTest, FitsEveryYardWithinTolerance) {
+    BallisticsOptions options = {};
+    options.engine = GetParam();
+    expect_fits(input(G1, 0.5), options, TRAJECTORY_DEFAULT_PATH_TOLERANCE, TRAJECTORY_DEFAULT_VELOCITY_TOLERANCE);
+    expect_fits(input(G7, 0.3), options, TRAJECTORY_DEFAULT_PATH_TOLERANCE, TRAJECTORY_DEFAULT_VELOCITY_TOLERANCE);
+    expect_fits(input(G7, 0.3), options, 0.001, 0.01);
+  }
+
+  TEST_P(TrajectoryTest, FitsAcrossWindZones) {
+    const double start[] = {0, 300, 600};
+    const double speed[] = {5, 15, 10};
+    const double angle[] = {90, 270, 0};
+    WindProfile* wind = WindProfile_create(start, speed, angle, 3);
+    BallisticsOptions options = {};
+    options.engine = GetParam();
+    options.wind = wind;
+    expect_fits(input(G7, 0.3), options, TRAJECTORY_DEFAULT_PATH_TOLERANCE, TRAJECTORY_DEFAULT_VELOCITY_TOLERANCE);
+    WindProfile_free(wind);
+  }
+
+  TEST_P(TrajectoryTest, IsCompact) {
+    BallisticsInput in = input(G7, 0.3);
+    BallisticsOptions options = {};
+    options.engine = GetParam();
+    Trajectory* loose = Trajectory_solve(3000, &in, &options, 0, 0);
+    Trajectory* tight = Trajectory_solve(3000, &in, &options, 0.001, 0.01);
+    ASSERT_NE(nullptr, loose);
+    ASSERT_NE(nullptr, tight);
+    // The table of the same solution is 3001 rows of BALLISTICS_COLUMNS doubles.
+    EXPECT_LT(Trajectory_get_size(loose), 4096u);
+    EXPECT_LT(Trajectory_get_knots(loose), Trajectory_get_knots(tight));
+    Trajectory_free(loose);
+    Trajectory_free(tight);
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Engines, TrajectoryTest,
+                           ::testing::Values(BALLISTICS_ENGINE_EULER, BALLISTICS_ENGINE_RK45));
+
+  TEST(TrajectoryCheck, TimeQueriesInvertRangeQueries) {
+    BallisticsInput in = input(G1, 0.5);
+    Trajectory* trajectory = Trajectory_solve(1000, &in, NULL, 0, 0);
+    ASSERT_NE(nullptr, trajectory);
+
+    double at_range[BALLISTICS_COLUMNS], at_time[BALLISTICS_COLUMNS];
+    for (double yards = 0.5; yards < 1000; yards += 12.25) {
+      ASSERT_EQ(0, Trajectory_at_range(trajectory, yards, at_range));
+      ASSERT_EQ(0, Trajectory_at_time(trajectory, at_range[BALLISTICS_COL_TIME], at_time));
+      EXPECT_NEAR(yards, at_time[BALLISTICS_COL_RANGE], 1e-9) << yards;
+      for (int column = 0; column < BALLISTICS_COLUMNS; column++) {
+        EXPECT_NEAR(at_range[column], at_time[column], 1e-6*(1 + fabs(at_range[column]))) << yards;
+      }
+    }
+
+    double row[BALLISTICS_COLUMNS];
+    EXPECT_EQ(-1, Trajectory_at_range(trajectory, -1, row));
+    EXPECT_EQ(-1, Trajectory_at_range(trajectory, 1000.5, row));
+    EXPECT_EQ(-1, Trajectory_at_time(trajectory, Trajectory_get_max_time(trajectory) + 0.01, row));
+    EXPECT_EQ(-1, Trajectory_at_range(trajectory, NAN, row));
+    Trajectory_free(trajectory);
+  }
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace {
+  // Impacts of a known load zeroed at 100 yards, at the given ranges, optionally offset per point.
+  std::vector<BallisticsTruingObservation> observe(const BallisticsInput& truth, const std::vector<double>& ranges,
+                                                   const std::vector<double>& noise = {}) {
+    BallisticsInput in = truth;
+    // Zeroed far more finely than zero_angle()'s 0.01 MOA, which alone moves the path by 0.1 in at 1000 yards.
+    BallisticsOptions options = {};
+    options.zero_method = ZERO_METHOD_SECANT;
+    options.zero_tolerance = 1e-7;
+    ZeroResult zero;
+    EXPECT_EQ(0, zero_angle_ex(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, 100, 0, &options, &zero));
+    in.zero_angle = zero.angle;
+    Ballistics* solution = Ballistics_create(1);
+    EXPECT_EQ((int)ranges.size(), Ballistics_solve_ranges(solution, ranges.data(), ranges.size(), &in, NULL));
+    std::vector<BallisticsTruingObservation> observations;
+    for (size_t i = 0; i < ranges.size(); i++) {
+      observations.push_back({ranges[i], Ballistics_get_path(solution, (int)i) + (noise.empty() ? 0 : noise[i]), 0});
+    }
+    Ballistics_free(solution);
+    return observations;
+  }
+
+  TEST(TruingTest, RecoversDragCoefficientAndVelocity) {
+    BallisticsInput truth = {G7, 0.243, 2710, 1.75, 0, 0, 0, 0};
+    std::vector<BallisticsTruingObservation> observations = observe(truth, {300, 400, 500, 600, 700, 800, 1000});
+
+    for (int threads : {1, 2}) {
+      BallisticsTruing truing = {};
+      truing.input = truth;
+      truing.input.drag_coefficient = 0.3;
+      truing.input.vi = 2850;
+      truing.zero_range = 100;
+      truing.observations = observations.data();
+      truing.observation_count = observations.size();
+      truing.threads = threads;
+
+      BallisticsTruingResult result;
+      std::vector<double> residuals(observations.size());
+      auto start = std::chrono::steady_clock::now();
+      ASSERT_EQ(0, Ballistics_truing(&truing, NULL, &result, residuals.data()));
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      RecordProperty("solves", result.solves);
+      RecordProperty("zero_solves", result.zero_solves);
+      RecordProperty("milliseconds", (int)(seconds*1000));
+      RecordProperty("iterations", result.iterations);
+      // Tens of milliseconds, even unoptimized; the bound only catches a fit gone badly wrong.
+      EXPECT_LT(seconds, 1.0);
+
+      EXPECT_NEAR(0.243, result.drag_coefficient, 1e-5);
+      EXPECT_NEAR(2710, result.vi, 0.1);
+      EXPECT_LT(result.rms, 1e-3);
+      for (double r : residuals) EXPECT_LT(std::fabs(r), 1e-3);
+      EXPECT_LE(result.iterations, 10);
+      EXPECT_LT(result.solves, 40);
+      EXPECT_NEAR(zero_angle(G7, result.drag_coefficient, result.vi, 1.75, 100, 0), result.zero_angle, 1e-3);
+    }
+  }
+
+  TEST(TruingTest, FitsOneParameterThroughNoise) {
+    BallisticsInput truth = {G1, 0.462, 2650, 1.5, 0, 0, 0, 0};
+    std::vector<BallisticsTruingObservation> observations =
+        observe(truth, {200, 300, 400, 500, 600}, {0.3, -0.4, 0.2, 0.5, -0.3});
+
+    BallisticsTruing truing = {};
+    truing.input = truth;
+    truing.input.drag_coefficient = 0.4;
+    truing.zero_range = 100;
+    truing.observations = observations.data();
+    truing.observation_count = observations.size();
+    truing.fit = BALLISTICS_TRUING_DRAG_COEFFICIENT;
+
+    BallisticsTruingResult result;
+    std::vector<double> residuals(observations.size());
+    ASSERT_EQ(0, Ballistics_truing(&truing, NULL, &result, residuals.data()));
+    EXPECT_EQ(2650, result.vi);
+    EXPECT_NEAR(0.462, result.drag_coefficient, 0.01);
+    EXPECT_NEAR(0.4, result.rms, 0.2);
+
+    // At the optimum the residuals are orthogonal to the Jacobian: nudging the coefficient either way is worse.
+    double best = 0;
+    for (double r : residuals) best += r*r;
+    for (double nudge : {-1e-3, 1e-3}) {
+      truing.input.drag_coefficient = result.drag_coefficient + nudge;
+      truing.max_iterations = 1;
+      truing.tolerance = 1;
+      BallisticsTruingResult nudged;
+      std::vector<double> nudged_residuals(observations.size());
+      Ballistics_truing(&truing, NULL, &nudged, nudged_residuals.data());
+      double cost = 0;
+      for (double r : nudged_residuals) cost += r*r;
+      EXPECT_LE(best, cost + 1e-9);
+    }
+  }
+
+  TEST(TruingTest, FixedBoreAngleAndWeights) {
+    BallisticsInput truth = {G7, 0.3, 2900, 1.5, 0, 0.06, 0, 0};
+    Ballistics* solution = Ballistics_create(1);
+    std::vector<double> ranges = {250, 500, 750};
+    ASSERT_EQ(3, Ballistics_solve_ranges(solution, ranges.data(), 3, &truth, NULL));
+    std::vector<BallisticsTruingObservation> observations;
+    for (int i = 0; i < 3; i++) {
+      observations.push_back({ranges[i], Ballistics_get_path(solution, i), 0.5 + i});
+    }
+    Ballistics_free(solution);
+
+    BallisticsTruing truing = {};
+    truing.input = truth;
+    truing.input.vi = 2800;
+    truing.observations = observations.data();
+    truing.observation_count = observations.size();
+    truing.fit = BALLISTICS_TRUING_VI;
+    BallisticsTruingResult result;
+    ASSERT_EQ(0, Ballistics_truing(&truing, NULL, &result, NULL));
+    EXPECT_NEAR(2900, result.vi, 0.01);
+    EXPECT_EQ(0.06, result.zero_angle);
+    EXPECT_EQ(0, result.zero_solves);
+  }
+
+  TEST(TruingTest, RejectsMalformedProblems) {
+    BallisticsTruingObservation observations[] = {{500, -50, 0}, {300, -10, 0}};
+    BallisticsTruing truing = {};
+    truing.input = {G1, 0.5, 2800, 1.5, 0, 0, 0, 0};
+    truing.zero_range = 100;
+    truing.observations = observations;
+    truing.observation_count = 2;
+    BallisticsTruingResult result;
+    EXPECT_EQ(BALLISTICS_TRUING_E_INVALID, Ballistics_truing(&truing, NULL, &result, NULL)); // not ascending
+    truing.observation_count = 1;
+    truing.fit = 4;
+    EXPECT_EQ(BALLISTICS_TRUING_E_INVALID, Ballistics_truing(&truing, NULL, &result, NULL));
+    truing.fit = 0;
+    truing.input.drag_coefficient = 0;
+    EXPECT_EQ(BALLISTICS_TRUING_E_INVALID, Ballistics_truing(&truing, NULL, &result, NULL));
+    EXPECT_EQ(BALLISTICS_TRUING_E_INVALID, Ballistics_truing(NULL, NULL, &result, NULL));
+
+    // A load too slow to reach the observation.
+    truing.input = {G1, 0.05, 300, 1.5, 0, 0, 0, 0};
+    observations[0].range = 20000;
+    EXPECT_EQ(BALLISTICS_TRUING_E_UNREACHABLE, Ballistics_truing(&truing, NULL, &result, NULL));
+  }
+}
@@ -0,0 +1,171 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ballistics/ballistics.h"
+
+namespace {
+  BallisticsInput input() {
+    BallisticsInput in = {};
+    in.drag_function = G7;
+    in.drag_coefficient = 0.3;
+    in.vi = 2800;
+    in.sight_height = 1.6;
+    in.zero_angle = zero_angle(G7, 0.3, 2800, 1.6, 100, 0);
+    in.wind_speed = 10;
+    in.wind_angle = 60;
+    return in;
+  }
+
+  class WindProfileTest : public ::testing::TestWithParam<BallisticsEngine> {
+  protected:
+    Ballistics* solve(const BallisticsInput& in, const WindProfile* wind) {
+      BallisticsOptions options = {};
+      options.engine = GetParam();
+      options.wind = wind;
+      Ballistics* solution = Ballistics_create(1000);
+      EXPECT_EQ(1001, Ballistics_solve_into(solution, 1000, &in, &options));
+      return solution;
+    }
+  };
+
+  TEST_P(WindProfileTest, OneZoneMatchesTheInputWind) {
+    BallisticsInput in = input();
+    double start = 0, speed = in.wind_speed, angle = in.wind_angle;
+    WindProfile* profile = WindProfile_create(&start, &speed, &angle, 1);
+    ASSERT_NE(nullptr, profile);
+
+    Ballistics* expected = solve(in, NULL);
+    in.wind_speed = 0; // ignored in favor of the profile
+    Ballistics* actual = solve(in, profile);
+    for (int yard = 0; yard <= 1000; yard++) {
+      EXPECT_EQ(Ballistics_get_path(expected, yard), Ballistics_get_path(actual, yard)) << yard;
+      EXPECT_EQ(Ballistics_get_windage(expected, yard), Ballistics_get_windage(actual, yard)) << yard;
+      EXPECT_EQ(Ballistics_get_v_fps(expected, yard), Ballistics_get_v_fps(actual, yard)) << yard;
+    }
+    Ballistics_free(expected);
+    Ballistics_free(actual);
+    WindProfile_free(profile);
+  }
+
+  TEST_P(WindProfileTest, SplittingAZoneChangesNothing) {
+    BallisticsInput in = input();
+    double start[] = {0, 250, 500}, speed[] = {10, 10, 10}, angle[] = {60, 60, 60};
+    WindProfile* profile = WindProfile_create(start, speed, angle, 3);
+
+    Ballistics* expected = solve(in, NULL);
+    Ballistics* actual = solve(in, profile);
+    for (int yard = 0; yard <= 1000; yard += 10) {
+      EXPECT_NEAR(Ballistics_get_windage(expected, yard), Ballistics_get_windage(actual, yard), 1e-6) << yard;
+      EXPECT_EQ(Ballistics_get_path(expected, yard), Ballistics_get_path(actual, yard)) << yard;
+    }
+    Ballistics_free(expected);
+    Ballistics_free(actual);
+    WindProfile_free(profile);
+  }
+
+  TEST_P(WindProfileTest, EachZoneActsOnlyOnItsOwnRange) {
+    BallisticsInput in = input();
+    in.wind_speed = 0;
+    // A full-value crosswind out to 300 yards, calm to 600, then a 20 mph headwind.
+    double start[] = {0, 300, 600}, speed[] = {10, 0, 20}, angle[] = {90, 0, 0};
+    WindProfile* profile = WindProfile_create(start, speed, angle, 3);
+
+    Ballistics* calm = solve(in, NULL);
+    Ballistics* windy = solve(in, profile);
+    EXPECT_GT(Ballistics_get_windage(windy, 300), 0);
+    // Only RK45's step that crosses 600 yards, which may start well short of it, sees the headwind early.
+    for (int yard = 0; yard < 600; yard++) {
+      EXPECT_NEAR(Ballistics_get_v_fps(calm, yard), Ballistics_get_v_fps(windy, yard), 0.01) << yard;
+    }
+    EXPECT_LT(Ballistics_get_v_fps(windy, 1000), Ballistics_get_v_fps(calm, 1000) - 5);
+    Ballistics_free(calm);
+    Ballistics_free(windy);
+    WindProfile_free(profile);
+  }
+
+  // Yards just short of a zone boundary are drifted by the zone they lie in, under either engine.
+  TEST_P(WindProfileTest, YardsShortOfABoundaryKeepTheirZone) {
+    BallisticsInput in = input();
+    in.wind_speed = 0;
+    double start[] = {0, 300}, speed[] = {10, 0}, angle[] = {90, 0};
+    WindProfile* profile = WindProfile_create(start, speed, angle, 2);
+    // The whole range in the first zone's wind, which the profile must follow up to 300 yards.
+    BallisticsInput steady = in;
+    steady.wind_speed = 10;
+    steady.wind_angle = 90;
+
+    Ballistics* windy = solve(in, profile);
+    Ballistics* reference = solve(steady, NULL);
+    // And the Euler engine's rows, which are each taken at the start of a step.
+    BallisticsOptions euler_options = {};
+    euler_options.wind = profile;
+    Ballistics* euler = Ballistics_create(1000);
+    ASSERT_EQ(1001, Ballistics_solve_into(euler, 1000, &in, &euler_options));
+    for (int yard = 250; yard < 300; yard++) {
+      EXPECT_NEAR(Ballistics_get_windage(reference, yard), Ballistics_get_windage(windy, yard), 0.01) << yard;
+      EXPECT_NEAR(Ballistics_get_windage(euler, yard), Ballistics_get_windage(windy, yard), 0.05) << yard;
+    }
+    EXPECT_LT(Ballistics_get_windage(windy, 279), Ballistics_get_windage(windy, 299) - 0.5);
+    Ballistics_free(windy);
+    Ballistics_free(reference);
+    Ballistics_free(euler);
+    WindProfile_free(profile);
+  }
+
+  // Past the boundary the bullet keeps the sideways velocity the first zone gave it, so the drift keeps growing
+  // through the calm.  And since drift is linear in the crosswind, the near and far zones' drifts add up to
+  // the drift of the same wind over the whole range.
+  TEST_P(WindProfileTest, DriftCarriesAcrossZones) {
+    BallisticsInput in = input();
+    in.wind_speed = 10;
+    in.wind_angle = 90;
+    Ballistics* steady = solve(in, NULL);
+    in.wind_speed = 0;
+    double start[] = {0, 300}, near_speed[] = {10, 0}, far_speed[] = {0, 10}, angle[] = {90, 90};
+    WindProfile* near_wind = WindProfile_create(start, near_speed, angle, 2);
+    WindProfile* far_wind = WindProfile_create(start, far_speed, angle, 2);
+
+    Ballistics* near = solve(in, near_wind);
+    Ballistics* far = solve(in, far_wind);
+    for (int yard = 300; yard <= 1000; yard += 10) {
+      double sum = Ballistics_get_windage(near, yard) + Ballistics_get_windage(far, yard);
+      EXPECT_NEAR(Ballistics_get_windage(steady, yard), sum, 1e-6) << yard;
+    }
+    for (int yard = 310; yard <= 1000; yard += 10) {
+      EXPECT_GT(Ballistics_get_windage(near, yard), Ballistics_get_windage(near, yard - 10) + 0.1) << yard;
+    }
+    EXPECT_NEAR(5.0, Ballistics_get_windage(near, 300), 0.1);
+    EXPECT_NEAR(29.7, Ballistics_get_windage(near, 1000), 0.3);
+    Ballistics_free(steady);
+    Ballistics_free(near);
+    Ballistics_free(far);
+    WindProfile_free(near_wind);
+    WindProfile_free(far_wind);
+  }
+
+  INSTANTIATE_TEST_SUITE_P(Engines, WindProfileTest,
+                           ::testing::Values(BALLISTICS_ENGINE_EULER, BALLISTICS_ENGINE_RK45));
+
+  TEST(WindProfileCreateTest, RejectsMalformedZones) {
+    double speed[] = {10, 10}, angle[] = {90, 90};
+    double late[] = {50, 100};
+    double unordered[] = {0, 0};
+    EXPECT_EQ(nullptr, WindProfile_create(late, speed, angle, 2));
+    EXPECT_EQ(nullptr, WindProfile_create(unordered, speed, angle, 2));
+    EXPECT_EQ(nullptr, WindProfile_create(late, speed, angle, 0));
+  }
+}
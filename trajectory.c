@@ -0,0 +1,344 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// The quantities fitted, each as a function of range in feet.
+enum {
+  FIT_PATH,    // inches
+  FIT_TIME,    // seconds
+  FIT_VX,
+  FIT_VY,
+  FIT_WINDAGE, // inches
+  FIT_QUANTITIES
+};
+
+// The most rows a segment spans, so that checking a candidate stays cheap.
+#define FIT_MAX_SPAN 256
+
+typedef struct {
+  double x;
+  double f[FIT_QUANTITIES];
+} FitRow;
+
+typedef struct {
+  double f[FIT_QUANTITIES];
+  double m[FIT_QUANTITIES]; // slopes, per foot
+} TrajectoryKnot;
+
+struct Trajectory {
+  int knots;
+  const double* x; // knot ranges, in feet, ascending; the search index
+  const TrajectoryKnot* knot;
+};
+
+/**
+ * Fits rows into a Trajectory as the integrator records them.  The open segment runs from row[0], the last knot
+ * placed, to the newest row.  Candidate ends take the central difference slope, so each is checked once the row
+ * after it arrives; good is the furthest one found to fit.
+ */
+typedef struct {
+  BallisticsRowSink sink;
+  double tolerance[FIT_QUANTITIES];
+  FitRow row[FIT_MAX_SPAN + 2];
+  int rows;
+  double slope[FIT_QUANTITIES]; // at row[0]
+  int good;
+  double good_slope[FIT_QUANTITIES];
+
+  double* x;
+  TrajectoryKnot* knot;
+  int knots;
+  int capacity;
+  int failed;
+} TrajectoryFit;
+
+static inline double hermite(double f0, double m0, double f1, double m1, double h, double s) {
+  double s2 = s*s, s3 = s2*s;
+  return (2*s3 - 3*s2 + 1)*f0 + (s3 - 2*s2 + s)*h*m0 + (3*s2 - 2*s3)*f1 + (s3 - s2)*h*m1;
+}
+
+// d/ds of hermite().
+static inline double hermite_ds(double f0, double m0, double f1, double m1, double h, double s) {
+  double s2 = s*s;
+  return (6*s2 - 6*s)*f0 + (3*s2 - 4*s + 1)*h*m0 + (6*s - 6*s2)*f1 + (3*s2 - 2*s)*h*m1;
+}
+
+static void TrajectoryFit_place(TrajectoryFit* fit, const FitRow* row, const double* slope) {
+  if (fit->knots == fit->capacity) {
+    int capacity = fit->capacity ? 2*fit->capacity : 32;
+    double* x = realloc(fit->x, sizeof(double) * capacity);
+    if (x) fit->x = x;
+    TrajectoryKnot* knot = realloc(fit->knot, sizeof(TrajectoryKnot) * capacity);
+    if (knot) fit->knot = knot;
+    if (x == NULL || knot == NULL) {
+      fit->failed = 1;
+      return;
+    }
+    fit->capacity = capacity;
+  }
+  fit->x[fit->knots] = row->x;
+  memcpy(fit->knot[fit->knots].f, row->f, sizeof(row->f));
+  memcpy(fit->knot[fit->knots].m, slope, sizeof(row->f));
+  fit->knots++;
+}
+
+// The slope at row i from its neighbours.
+static void TrajectoryFit_central(const TrajectoryFit* fit, int i, double* slope) {
+  const FitRow* a = &fit->row[i-1];
+  const FitRow* b = &fit->row[i+1];
+  for (int q = 0; q < FIT_QUANTITIES; q++) {
+    slope[q] = (b->f[q] - a->f[q]) / (b->x - a->x);
+  }
+}
+
+// The slope at row i from rows i + d and i + 2d, for d = 1 at the start and -1 at the end.
+static void TrajectoryFit_one_sided(const TrajectoryFit* fit, int i, int d, double* slope) {
+  const FitRow* r0 = &fit->row[i];
+  const FitRow* r1 = &fit->row[i + d];
+  const FitRow* r2 = &fit->row[i + 2*d];
+  double h1 = r1->x - r0->x, h2 = r2->x - r1->x;
+  for (int q = 0; q < FIT_QUANTITIES; q++) {
+    slope[q] = -(2*h1 + h2)/(h1*(h1 + h2))*r0->f[q] + (h1 + h2)/(h1*h2)*r1->f[q] - h1/(h2*(h1 + h2))*r2->f[q];
+  }
+}
+
+// Whether the segment from row[0] to row[end], with slope at row[end], reproduces every row between.
+static int TrajectoryFit_fits(const TrajectoryFit* fit, int end, const double* slope) {
+  const FitRow* r0 = &fit->row[0];
+  const FitRow* r1 = &fit->row[end];
+  double h = r1->x - r0->x;
+  for (int i = 1; i < end; i++) {
+    double s = (fit->row[i].x - r0->x)/h;
+    for (int q = 0; q < FIT_QUANTITIES; q++) {
+      double f = hermite(r0->f[q], fit->slope[q], r1->f[q], slope[q], h, s);
+      if (!(fabs(f - fit->row[i].f[q]) <= fit->tolerance[q])) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+// Ends the open segment at the furthest row that fits, which opens the next one.
+static void TrajectoryFit_close(TrajectoryFit* fit) {
+  int good = fit->good;
+  TrajectoryFit_place(fit, &fit->row[good], fit->good_slope);
+  fit->rows -= good;
+  memmove(fit->row, fit->row + good, sizeof(FitRow) * fit->rows);
+  memcpy(fit->slope, fit->good_slope, sizeof(fit->slope));
+  fit->good = 0;
+}
+
+static void TrajectoryFit_add(BallisticsRowSink* sink, double x, double y, double t, double v, double vx,
+                              double vy, double windage_inches) {
+  (void)v;
+  TrajectoryFit* fit = (TrajectoryFit*)sink;
+  FitRow* row = &fit->row[fit->rows++];
+  row->x = x;
+  row->f[FIT_PATH] = y*12;
+  row->f[FIT_TIME] = t;
+  row->f[FIT_VX] = vx;
+  row->f[FIT_VY] = vy;
+  row->f[FIT_WINDAGE] = windage_inches;
+  if (fit->rows < 3) {
+    return;
+  }
+  if (fit->knots == 0 && fit->rows == 3) {
+    TrajectoryFit_one_sided(fit, 0, 1, fit->slope);
+    TrajectoryFit_place(fit, &fit->row[0], fit->slope);
+  }
+
+  int end = fit->rows - 2;
+  double slope[FIT_QUANTITIES];
+  TrajectoryFit_central(fit, end, slope);
+  while (end >= FIT_MAX_SPAN || !TrajectoryFit_fits(fit, end, slope)) {
+    end -= fit->good;
+    TrajectoryFit_close(fit);
+  }
+  fit->good = end;
+  memcpy(fit->good_slope, slope, sizeof(slope));
+}
+
+// Places the last knot, at the last row.
+static void TrajectoryFit_finish(TrajectoryFit* fit) {
+  double slope[FIT_QUANTITIES];
+  int last = fit->rows - 1;
+  if (fit->rows < 3) {
+    // Too short to have placed the first knot: one straight segment, or a single point.
+    for (int q = 0; q < FIT_QUANTITIES; q++) {
+      slope[q] = last > 0 ? (fit->row[1].f[q] - fit->row[0].f[q]) / (fit->row[1].x - fit->row[0].x) : 0;
+    }
+    for (int i = 0; i <= last; i++) {
+      TrajectoryFit_place(fit, &fit->row[i], slope);
+    }
+    return;
+  }
+  TrajectoryFit_one_sided(fit, last, -1, slope);
+  if (!TrajectoryFit_fits(fit, last, slope)) {
+    TrajectoryFit_close(fit);
+    last = fit->rows - 1;
+  }
+  TrajectoryFit_place(fit, &fit->row[last], slope);
+}
+
+Trajectory* Trajectory_solve(size_t max_yards, const BallisticsInput* in, const BallisticsOptions* options,
+                             double path_tolerance, double velocity_tolerance) {
+  if (path_tolerance <= 0) path_tolerance = TRAJECTORY_DEFAULT_PATH_TOLERANCE;
+  if (velocity_tolerance <= 0) velocity_tolerance = TRAJECTORY_DEFAULT_VELOCITY_TOLERANCE;
+
+  TrajectoryFit* fit = calloc(1, sizeof(TrajectoryFit));
+  if (fit == NULL) {
+    return NULL;
+  }
+  fit->sink.row = TrajectoryFit_add;
+  fit->tolerance[FIT_PATH] = path_tolerance;
+  fit->tolerance[FIT_WINDAGE] = path_tolerance;
+  fit->tolerance[FIT_TIME] = path_tolerance/12 / in->vi;
+  fit->tolerance[FIT_VX] = fit->tolerance[FIT_VY] = velocity_tolerance/sqrt(2);
+
+  int rows = max_yards < BALLISTICS_COMPUTATION_MAX_YARDS ? (int)max_yards + 1 : BALLISTICS_COMPUTATION_MAX_YARDS;
+  BallisticsSamples samples = {NULL, 0, 1, rows, 1};
+  Ballistics shell = {0};
+  shell.refs = 1;
+  shell.sink = &fit->sink;
+  Ballistics_integrate(&shell, &samples, in, options);
+  TrajectoryFit_finish(fit);
+
+  Trajectory* trajectory = NULL;
+  if (!fit->failed) {
+    trajectory = malloc(sizeof(Trajectory) + (sizeof(double) + sizeof(TrajectoryKnot)) * fit->knots);
+  }
+  if (trajectory) {
+    double* x = (double*)(trajectory + 1);
+    TrajectoryKnot* knot = (TrajectoryKnot*)(x + fit->knots);
+    memcpy(x, fit->x, sizeof(double) * fit->knots);
+    memcpy(knot, fit->knot, sizeof(TrajectoryKnot) * fit->knots);
+    trajectory->knots = fit->knots;
+    trajectory->x = x;
+    trajectory->knot = knot;
+  }
+  free(fit->x);
+  free(fit->knot);
+  free(fit);
+  return trajectory;
+}
+
+void Trajectory_free(Trajectory* trajectory) {
+  free(trajectory);
+}
+
+// The segment [i, i+1] that holds value, for values ascending at stride doubles apart.
+static int Trajectory_search(const double* values, size_t stride, int n, double value) {
+  int lo = 0, hi = n - 1;
+  while (hi - lo > 1) {
+    int mid = (lo + hi)/2;
+    if (values[mid*stride] <= value) lo = mid; else hi = mid;
+  }
+  return lo;
+}
+
+// Fills row from segment i at fraction s of its length.
+static void Trajectory_row(const Trajectory* trajectory, int i, double s, double* row) {
+  double f[FIT_QUANTITIES];
+  double x;
+  if (trajectory->knots == 1) {
+    memcpy(f, trajectory->knot[0].f, sizeof(f));
+    x = trajectory->x[0];
+  }
+  else {
+    const TrajectoryKnot* k0 = &trajectory->knot[i];
+    const TrajectoryKnot* k1 = &trajectory->knot[i+1];
+    double h = trajectory->x[i+1] - trajectory->x[i];
+    for (int q = 0; q < FIT_QUANTITIES; q++) {
+      f[q] = hermite(k0->f[q], k0->m[q], k1->f[q], k1->m[q], h, s);
+    }
+    x = trajectory->x[i] + s*h;
+  }
+  row[BALLISTICS_COL_RANGE] = x/3;
+  row[BALLISTICS_COL_PATH] = f[FIT_PATH];
+  row[BALLISTICS_COL_MOA] = -rad_to_moa(atan((f[FIT_PATH]/12) / x));
+  row[BALLISTICS_COL_TIME] = f[FIT_TIME];
+  row[BALLISTICS_COL_WINDAGE] = f[FIT_WINDAGE];
+  row[BALLISTICS_COL_WINDAGE_MOA] = rad_to_moa(atan((f[FIT_WINDAGE]/12) / x));
+  row[BALLISTICS_COL_V] = sqrt(f[FIT_VX]*f[FIT_VX] + f[FIT_VY]*f[FIT_VY]);
+  row[BALLISTICS_COL_VX] = f[FIT_VX];
+  row[BALLISTICS_COL_VY] = f[FIT_VY];
+}
+
+int Trajectory_at_range(const Trajectory* trajectory, double yards, double* row) {
+  int n = trajectory->knots;
+  double x = yards*3;
+  if (n == 0 || !(x >= trajectory->x[0] && x <= trajectory->x[n-1])) {
+    return -1;
+  }
+  int i = Trajectory_search(trajectory->x, 1, n, x);
+  double s = n > 1 ? (x - trajectory->x[i]) / (trajectory->x[i+1] - trajectory->x[i]) : 0;
+  Trajectory_row(trajectory, i, s, row);
+  return 0;
+}
+
+int Trajectory_at_time(const Trajectory* trajectory, double seconds, double* row) {
+  int n = trajectory->knots;
+  size_t stride = sizeof(TrajectoryKnot)/sizeof(double);
+  const double* times = trajectory->knot[0].f + FIT_TIME;
+  if (n == 0 || !(seconds >= times[0] && seconds <= times[(n-1)*stride])) {
+    return -1;
+  }
+  if (n == 1) {
+    Trajectory_row(trajectory, 0, 0, row);
+    return 0;
+  }
+
+  // Time rises through the segment, so Newton's method, kept inside the bracket, finds s in a few steps.
+  int i = Trajectory_search(times, stride, n, seconds);
+  const TrajectoryKnot* k0 = &trajectory->knot[i];
+  const TrajectoryKnot* k1 = &trajectory->knot[i+1];
+  double h = trajectory->x[i+1] - trajectory->x[i];
+  double t0 = k0->f[FIT_TIME], m0 = k0->m[FIT_TIME], t1 = k1->f[FIT_TIME], m1 = k1->m[FIT_TIME];
+  double lo = 0, hi = 1;
+  double s = t1 > t0 ? (seconds - t0)/(t1 - t0) : 0;
+  for (int iteration = 0; iteration < 50; iteration++) {
+    double e = hermite(t0, m0, t1, m1, h, s) - seconds;
+    if (e == 0) break;
+    if (e > 0) hi = s; else lo = s;
+    double next = s - e/hermite_ds(t0, m0, t1, m1, h, s);
+    if (!(next > lo && next < hi)) next = (lo + hi)/2;
+    if (fabs(next - s) < 1e-15) break;
+    s = next;
+  }
+  Trajectory_row(trajectory, i, s, row);
+  return 0;
+}
+
+double Trajectory_get_max_range(const Trajectory* trajectory) {
+  return trajectory->knots ? trajectory->x[trajectory->knots - 1]/3 : 0;
+}
+
+double Trajectory_get_max_time(const Trajectory* trajectory) {
+  return trajectory->knots ? trajectory->knot[trajectory->knots - 1].f[FIT_TIME] : 0;
+}
+
+int Trajectory_get_knots(const Trajectory* trajectory) {
+  return trajectory->knots;
+}
+
+size_t Trajectory_get_size(const Trajectory* trajectory) {
+  return sizeof(Trajectory) + (sizeof(double) + sizeof(TrajectoryKnot)) * trajectory->knots;
+}
@@ -0,0 +1,339 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define TRUING_MAX_PARAMETERS 2
+#define TRUING_DEFAULT_TOLERANCE 1e-6
+#define TRUING_DEFAULT_ITERATIONS 50
+#define TRUING_ZERO_TOLERANCE 1e-7  // MOA; well inside the difference steps, so zeroing does not blur the Jacobian
+#define TRUING_DIFFERENCE_STEP 1e-6 // forward difference step, as a fraction of the parameter
+#define TRUING_LAMBDA0 1e-3
+#define TRUING_LAMBDA_MAX 1e10
+
+/**
+ * One residual evaluation: a trial load, and the path it solves at every observation, in inches.
+ */
+typedef struct {
+  double p[TRUING_MAX_PARAMETERS];
+  Ballistics* solution;
+  double* path;
+  double zero_angle;
+  int zero_solves;
+  int status;
+} TruingTrial;
+
+/**
+ * A fit in progress.  A batch of trials is solved by claiming them from next.
+ */
+typedef struct {
+  const BallisticsTruing* truing;
+  BallisticsOptions options;
+  double* ranges;
+  int parameters;
+  int which[TRUING_MAX_PARAMETERS]; // BALLISTICS_TRUING_* flag of each fitted parameter
+  TruingTrial* batch;
+  int batch_size;
+  atomic_int next;
+} Truing;
+
+static void truing_solve(const Truing* fit, TruingTrial* trial) {
+  const BallisticsTruing* truing = fit->truing;
+  BallisticsInput in = truing->input;
+  for (int j = 0; j < fit->parameters; j++) {
+    if (fit->which[j] == BALLISTICS_TRUING_DRAG_COEFFICIENT) {
+      in.drag_coefficient = trial->p[j];
+    }
+    else {
+      in.vi = trial->p[j];
+    }
+  }
+
+  trial->zero_solves = 0;
+  if (truing->zero_range > 0) {
+    ZeroResult zero;
+    int status = zero_angle_ex(in.drag_function, in.drag_coefficient, in.vi, in.sight_height, truing->zero_range, 0,
+                               &fit->options, &zero);
+    trial->zero_solves = zero.iterations;
+    if (status != 0) {
+      trial->status = BALLISTICS_TRUING_E_UNREACHABLE;
+      return;
+    }
+    in.zero_angle = zero.angle;
+  }
+  trial->zero_angle = in.zero_angle;
+
+  int n = (int)truing->observation_count;
+  if (Ballistics_solve_ranges(trial->solution, fit->ranges, n, &in, &fit->options) != n) {
+    trial->status = BALLISTICS_TRUING_E_UNREACHABLE;
+    return;
+  }
+  memcpy(trial->path, Ballistics_column(trial->solution, BALLISTICS_COL_PATH), n*sizeof(double));
+  trial->status = 0;
+}
+
+static void* truing_run(void* arg) {
+  Truing* fit = (Truing*)arg;
+  for (;;) {
+    int k = atomic_fetch_add(&fit->next, 1);
+    if (k >= fit->batch_size) break;
+    truing_solve(fit, &fit->batch[k]);
+  }
+  return NULL;
+}
+
+// Solves trials[0, count), on up to truing->threads threads including the calling one.
+static void truing_solve_batch(Truing* fit, TruingTrial* trials, int count) {
+  fit->batch = trials;
+  fit->batch_size = count;
+  atomic_store(&fit->next, 0);
+
+  int threads = fit->truing->threads > 1 ? fit->truing->threads : 1;
+  if (threads > count) threads = count;
+  pthread_t handles[TRUING_MAX_PARAMETERS];
+  int started = 0;
+  for (int t = 1; t < threads; t++) {
+    if (pthread_create(&handles[started], NULL, truing_run, fit) == 0) {
+      started++;
+    }
+  }
+  truing_run(fit);
+  for (int t = 0; t < started; t++) {
+    pthread_join(handles[t], NULL);
+  }
+}
+
+// The weighted sum of squared residuals of a solved trial.
+static double truing_cost(const BallisticsTruing* truing, const TruingTrial* trial) {
+  double cost = 0;
+  for (size_t i = 0; i < truing->observation_count; i++) {
+    const BallisticsTruingObservation* o = &truing->observations[i];
+    double r = (o->path - trial->path[i]) / (o->sd > 0 ? o->sd : 1);
+    cost += r*r;
+  }
+  return cost;
+}
+
+// Solves (A + lambda*diag(A)) delta = g for up to TRUING_MAX_PARAMETERS unknowns.
+// @return 0, or -1 if the system is singular.
+static int truing_step(int parameters, double a[TRUING_MAX_PARAMETERS][TRUING_MAX_PARAMETERS],
+                       const double* g, double lambda, double* delta) {
+  double m[TRUING_MAX_PARAMETERS][TRUING_MAX_PARAMETERS];
+  for (int j = 0; j < parameters; j++) {
+    for (int k = 0; k < parameters; k++) {
+      m[j][k] = a[j][k] + (j == k ? lambda*a[j][k] : 0);
+    }
+  }
+  if (parameters == 1) {
+    if (!(m[0][0] > 0)) return -1;
+    delta[0] = g[0]/m[0][0];
+    return 0;
+  }
+  double det = m[0][0]*m[1][1] - m[0][1]*m[1][0];
+  if (!(fabs(det) > 0)) return -1;
+  delta[0] = (g[0]*m[1][1] - m[0][1]*g[1])/det;
+  delta[1] = (m[0][0]*g[1] - m[1][0]*g[0])/det;
+  return 0;
+}
+
+static int truing_valid(const BallisticsTruing* truing) {
+  if (truing->observations == NULL || truing->observation_count == 0 ||
+      truing->observation_count > BALLISTICS_COMPUTATION_MAX_YARDS || !(truing->zero_range >= 0) ||
+      !(truing->tolerance >= 0) || truing->max_iterations < 0 || (truing->fit & ~3) != 0 ||
+      !(truing->input.drag_coefficient > 0) || !(truing->input.vi > 0)) {
+    return 0;
+  }
+  for (size_t i = 0; i < truing->observation_count; i++) {
+    const BallisticsTruingObservation* o = &truing->observations[i];
+    if (!(o->range > 0) || !isfinite(o->path) || !(o->sd >= 0) ||
+        (i > 0 && o->range < truing->observations[i-1].range)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int Ballistics_truing(const BallisticsTruing* truing, const BallisticsOptions* options,
+                      BallisticsTruingResult* result, double* residuals) {
+  if (truing == NULL || result == NULL || !truing_valid(truing)) {
+    return BALLISTICS_TRUING_E_INVALID;
+  }
+  memset(result, 0, sizeof(*result));
+
+  Truing fit;
+  memset(&fit, 0, sizeof(fit));
+  fit.truing = truing;
+  if (options) {
+    fit.options = *options;
+  }
+  // Trials are solved concurrently, so they cannot share one stats record.
+  fit.options.stats = NULL;
+  fit.options.zero_method = ZERO_METHOD_SECANT;
+  fit.options.zero_tolerance = TRUING_ZERO_TOLERANCE;
+
+  int flags = truing->fit ? truing->fit : BALLISTICS_TRUING_DRAG_COEFFICIENT | BALLISTICS_TRUING_VI;
+  double p[TRUING_MAX_PARAMETERS];
+  if (flags & BALLISTICS_TRUING_DRAG_COEFFICIENT) {
+    fit.which[fit.parameters] = BALLISTICS_TRUING_DRAG_COEFFICIENT;
+    p[fit.parameters++] = truing->input.drag_coefficient;
+  }
+  if (flags & BALLISTICS_TRUING_VI) {
+    fit.which[fit.parameters] = BALLISTICS_TRUING_VI;
+    p[fit.parameters++] = truing->input.vi;
+  }
+
+  // The current load, a trial step from it, and one difference per parameter; each solves into its own handle.
+  int n = (int)truing->observation_count;
+  int trials = 2 + fit.parameters;
+  TruingTrial trial[2 + TRUING_MAX_PARAMETERS];
+  memset(trial, 0, sizeof(trial));
+  fit.ranges = malloc(sizeof(double) * n * (1 + trials));
+  int status = fit.ranges ? 0 : BALLISTICS_TRUING_E_INVALID;
+  for (int k = 0; k < trials && status == 0; k++) {
+    trial[k].path = fit.ranges + (size_t)n*(1 + k);
+    trial[k].solution = Ballistics_alloc(n);
+    if (trial[k].solution == NULL) status = BALLISTICS_TRUING_E_INVALID;
+  }
+  if (status == 0) {
+    for (int i = 0; i < n; i++) {
+      fit.ranges[i] = truing->observations[i].range;
+    }
+  }
+
+  TruingTrial* current = &trial[0];
+  TruingTrial* next = &trial[1];
+  TruingTrial* columns = &trial[2];
+  int solves = 0, zero_solves = 0, iterations = 0;
+  if (status == 0) {
+    memcpy(current->p, p, sizeof(p));
+    truing_solve(&fit, current);
+    solves++;
+    zero_solves += current->zero_solves;
+    status = current->status;
+  }
+
+  double tolerance = truing->tolerance > 0 ? truing->tolerance : TRUING_DEFAULT_TOLERANCE;
+  int max_iterations = truing->max_iterations > 0 ? truing->max_iterations : TRUING_DEFAULT_ITERATIONS;
+  double lambda = TRUING_LAMBDA0;
+  double cost = status == 0 ? truing_cost(truing, current) : 0;
+  int converged = 0;
+  while (status == 0 && !converged && iterations < max_iterations) {
+    iterations++;
+
+    // The Jacobian of the solved paths, a column per parameter, solved concurrently.
+    double h[TRUING_MAX_PARAMETERS];
+    for (int j = 0; j < fit.parameters; j++) {
+      memcpy(columns[j].p, current->p, sizeof(current->p));
+      h[j] = TRUING_DIFFERENCE_STEP * current->p[j];
+      columns[j].p[j] += h[j];
+    }
+    truing_solve_batch(&fit, columns, fit.parameters);
+    solves += fit.parameters;
+    for (int j = 0; j < fit.parameters; j++) {
+      zero_solves += columns[j].zero_solves;
+      if (columns[j].status != 0) status = columns[j].status;
+    }
+    if (status != 0) break;
+
+    // The normal equations, weighted: a = J'J and g = J'r.
+    double a[TRUING_MAX_PARAMETERS][TRUING_MAX_PARAMETERS] = {{0}};
+    double g[TRUING_MAX_PARAMETERS] = {0};
+    for (int i = 0; i < n; i++) {
+      const BallisticsTruingObservation* o = &truing->observations[i];
+      double w = 1 / (o->sd > 0 ? o->sd : 1);
+      double r = (o->path - current->path[i]) * w;
+      double jac[TRUING_MAX_PARAMETERS];
+      for (int j = 0; j < fit.parameters; j++) {
+        jac[j] = (columns[j].path[i] - current->path[i]) / h[j] * w;
+        g[j] += jac[j]*r;
+      }
+      for (int j = 0; j < fit.parameters; j++) {
+        for (int k = 0; k < fit.parameters; k++) {
+          a[j][k] += jac[j]*jac[k];
+        }
+      }
+    }
+
+    // Raise lambda until a step lowers the cost.  If none can, the current load is the best there is.
+    for (;;) {
+      double delta[TRUING_MAX_PARAMETERS];
+      if (lambda > TRUING_LAMBDA_MAX || truing_step(fit.parameters, a, g, lambda, delta) != 0) {
+        converged = 1;
+        break;
+      }
+      int small = 1;
+      int positive = 1;
+      for (int j = 0; j < fit.parameters; j++) {
+        next->p[j] = current->p[j] + delta[j];
+        small &= fabs(delta[j]) <= tolerance*fabs(current->p[j]);
+        positive &= next->p[j] > 0;
+      }
+      if (positive) {
+        truing_solve(&fit, next);
+        solves++;
+        zero_solves += next->zero_solves;
+      }
+      if (positive && next->status == 0 && truing_cost(truing, next) <= cost) {
+        cost = truing_cost(truing, next);
+        TruingTrial* accepted = next;
+        next = current;
+        current = accepted;
+        lambda = fmax(lambda/10, 1e-12);
+        converged = small;
+        break;
+      }
+      if (small) {
+        converged = 1;
+        break;
+      }
+      lambda *= 10;
+    }
+  }
+
+  if (status == 0 || iterations > 0) {
+    result->drag_coefficient = truing->input.drag_coefficient;
+    result->vi = truing->input.vi;
+    for (int j = 0; j < fit.parameters; j++) {
+      if (fit.which[j] == BALLISTICS_TRUING_DRAG_COEFFICIENT) result->drag_coefficient = current->p[j];
+      else result->vi = current->p[j];
+    }
+    result->zero_angle = current->zero_angle;
+    result->rms = sqrt(cost / n);
+    if (residuals) {
+      for (int i = 0; i < n; i++) {
+        residuals[i] = truing->observations[i].path - current->path[i];
+      }
+    }
+  }
+  result->iterations = iterations;
+  result->solves = solves;
+  result->zero_solves = zero_solves;
+  if (status == 0 && !converged) {
+    status = BALLISTICS_TRUING_E_MAX_ITERATIONS;
+  }
+
+  for (int k = 0; k < trials; k++) {
+    if (trial[k].solution) Ballistics_free(trial[k].solution);
+  }
+  free(fit.ranges);
+  return status;
+}
@@ -0,0 +1,49 @@
+/**
+ * Copyright 2017 William Grim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ballistics_private.h"
+
+#include <stdlib.h>
+
+WindProfile* WindProfile_create(const double* start_yards, const double* speed, const double* angle, size_t n) {
+  if (n < 1 || start_yards == NULL || speed == NULL || angle == NULL || start_yards[0] != 0) {
+    return NULL;
+  }
+  for (size_t k = 1; k < n; k++) {
+    if (!(start_yards[k] > start_yards[k-1]) || !isfinite(start_yards[k])) {
+      return NULL;
+    }
+  }
+
+  WindProfile* profile = malloc(sizeof(WindProfile) + sizeof(WindZone) * (n + 1));
+  if (profile == NULL) {
+    return NULL;
+  }
+  profile->zones = (int)n;
+  for (size_t k = 0; k < n; k++) {
+    profile->zone[k].start = start_yards[k]*3;
+    profile->zone[k].headwind = headwind(speed[k], angle[k]);
+    profile->zone[k].crosswind = crosswind(speed[k], angle[k]);
+  }
+  // A sentinel zone no trajectory reaches, so the cursor never checks for the end.
+  profile->zone[n].start = INFINITY;
+  profile->zone[n].headwind = profile->zone[n].crosswind = 0;
+  return profile;
+}
+
+void WindProfile_free(WindProfile* profile) {
+  free(profile);
+}